@@ -0,0 +1,441 @@
+#include <Core.h>
+#include <Utility.h>
+#include <IO.h>
+
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#if defined(LIE_PLATFORM_LINUX)
+#include <pty.h>
+#elif defined(LIE_PLATFORM_MACOS)
+#include <util.h>
+#endif
+
+#define SCREEN_WIDTH          80
+#define SCREEN_HEIGHT         24
+#define LATENCY_SAMPLES       200
+#define LATENCY_WARMUP        10
+#define LATENCY_TIMEOUT       2000000000
+#define LATENCY_SETTLE        300000000
+#define LATENCY_QUIET         20000000
+#define ESCAPE_PARAMETER_SIZE 16
+
+typedef enum ParserState
+{
+    PARSER_STATE_GROUND,
+    PARSER_STATE_ESCAPE,
+    PARSER_STATE_CSI,
+} ParserState;
+
+typedef struct VirtualScreen
+{
+    char Cells[SCREEN_HEIGHT][SCREEN_WIDTH];
+    u16 CursorX;
+    u16 CursorY;
+
+    ParserState State;
+    bool Private;
+    u16 Parameters[ESCAPE_PARAMETER_SIZE];
+    usize ParameterCount;
+
+    u64 Frames;
+} VirtualScreen;
+
+typedef struct LatencyScenario
+{
+    const char* Name;
+    const char* Setup;
+    const char* Keys[4];
+    usize KeyCount;
+    u64 Samples[LATENCY_SAMPLES];
+    usize SampleCount;
+} LatencyScenario;
+
+void ClearScreenCells(VirtualScreen* screen, u16 fromY, u16 fromX, u16 toY, u16 toX)
+{
+    for (u16 y = fromY; y <= toY && y < SCREEN_HEIGHT; y += 1)
+    {
+        u16 startX = (y == fromY) ? fromX : 0;
+        u16 endX = (y == toY) ? toX : SCREEN_WIDTH - 1;
+        for (u16 x = startX; x <= endX && x < SCREEN_WIDTH; x += 1)
+            screen->Cells[y][x] = ' ';
+    }
+}
+
+void InitializeVirtualScreen(VirtualScreen* screen)
+{
+    ClearScreenCells(screen, 0, 0, SCREEN_HEIGHT - 1, SCREEN_WIDTH - 1);
+    screen->CursorX = 0;
+    screen->CursorY = 0;
+    screen->State = PARSER_STATE_GROUND;
+    screen->Private = false;
+    screen->ParameterCount = 0;
+    screen->Frames = 0;
+}
+
+u16 GetParameter(VirtualScreen* screen, usize index, u16 fallback)
+{
+    if (index >= screen->ParameterCount || screen->Parameters[index] == 0)
+        return fallback;
+
+    return screen->Parameters[index];
+}
+
+void ExecuteControlSequence(VirtualScreen* screen, char final)
+{
+    switch (final)
+    {
+        case 'H':
+        case 'f':
+            screen->CursorY = (u16)Min(GetParameter(screen, 0, 1) - 1, SCREEN_HEIGHT - 1);
+            screen->CursorX = (u16)Min(GetParameter(screen, 1, 1) - 1, SCREEN_WIDTH - 1);
+            break;
+        case 'K':
+            switch (GetParameter(screen, 0, 0))
+            {
+                case 0: ClearScreenCells(screen, screen->CursorY, screen->CursorX, screen->CursorY, SCREEN_WIDTH - 1); break;
+                case 1: ClearScreenCells(screen, screen->CursorY, 0, screen->CursorY, screen->CursorX); break;
+                default: ClearScreenCells(screen, screen->CursorY, 0, screen->CursorY, SCREEN_WIDTH - 1); break;
+            }
+            break;
+        case 'J':
+            switch (GetParameter(screen, 0, 0))
+            {
+                case 0: ClearScreenCells(screen, screen->CursorY, screen->CursorX, SCREEN_HEIGHT - 1, SCREEN_WIDTH - 1); break;
+                case 1: ClearScreenCells(screen, 0, 0, screen->CursorY, screen->CursorX); break;
+                default: ClearScreenCells(screen, 0, 0, SCREEN_HEIGHT - 1, SCREEN_WIDTH - 1); break;
+            }
+            break;
+        case 'h':
+            if (screen->Private && GetParameter(screen, 0, 0) == 25)
+                screen->Frames += 1;
+            else if (screen->Private && GetParameter(screen, 0, 0) == 1049)
+                ClearScreenCells(screen, 0, 0, SCREEN_HEIGHT - 1, SCREEN_WIDTH - 1);
+            break;
+        default:
+            break;
+    }
+}
+
+void FeedVirtualScreen(VirtualScreen* screen, const char* bytes, usize count)
+{
+    for (usize index = 0; index < count; index += 1)
+    {
+        char byte = bytes[index];
+        switch (screen->State)
+        {
+            case PARSER_STATE_GROUND:
+                if (byte == '\x1B')
+                {
+                    screen->State = PARSER_STATE_ESCAPE;
+                }
+                else if (byte == '\r')
+                {
+                    screen->CursorX = 0;
+                }
+                else if (byte == '\n')
+                {
+                    screen->CursorY = (u16)Min(screen->CursorY + 1, SCREEN_HEIGHT - 1);
+                }
+                else if ((u8)byte >= 0x20)
+                {
+                    if (screen->CursorX < SCREEN_WIDTH)
+                        screen->Cells[screen->CursorY][screen->CursorX] = byte;
+
+                    screen->CursorX = (u16)Min(screen->CursorX + 1, SCREEN_WIDTH);
+                }
+                break;
+
+            case PARSER_STATE_ESCAPE:
+                if (byte == '[')
+                {
+                    screen->State = PARSER_STATE_CSI;
+                    screen->Private = false;
+                    screen->ParameterCount = 1;
+                    screen->Parameters[0] = 0;
+                }
+                else
+                {
+                    screen->State = PARSER_STATE_GROUND;
+                }
+                break;
+
+            case PARSER_STATE_CSI:
+                if (byte == '?')
+                {
+                    screen->Private = true;
+                }
+                else if (IsDigit(byte))
+                {
+                    u16* parameter = &screen->Parameters[screen->ParameterCount - 1];
+                    *parameter = (u16)(*parameter * 10 + (u16)(byte - '0'));
+                }
+                else if (byte == ';')
+                {
+                    if (screen->ParameterCount < ESCAPE_PARAMETER_SIZE)
+                    {
+                        screen->Parameters[screen->ParameterCount] = 0;
+                        screen->ParameterCount += 1;
+                    }
+                }
+                else
+                {
+                    ExecuteControlSequence(screen, byte);
+                    screen->State = PARSER_STATE_GROUND;
+                }
+                break;
+        }
+    }
+}
+
+bool ScreensDiffer(VirtualScreen* left, VirtualScreen* right)
+{
+    if (left->CursorX != right->CursorX || left->CursorY != right->CursorY)
+        return true;
+
+    for (u16 y = 0; y < SCREEN_HEIGHT; y += 1)
+    {
+        for (u16 x = 0; x < SCREEN_WIDTH; x += 1)
+        {
+            if (left->Cells[y][x] != right->Cells[y][x])
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool PumpOutput(i32 master, VirtualScreen* screen, u64 timeout)
+{
+    struct pollfd descriptor = {.fd = master, .events = POLLIN};
+    if (poll(&descriptor, 1, (int)Max(timeout / 1000000, 1)) <= 0)
+        return false;
+
+    char buffer[4096];
+    isize readBytes = read(master, buffer, sizeof(buffer));
+    if (readBytes <= 0)
+        return false;
+
+    FeedVirtualScreen(screen, buffer, (usize)readBytes);
+    return true;
+}
+
+void DrainOutput(i32 master, VirtualScreen* screen, u64 duration)
+{
+    u64 start = GetMonotonicTime();
+    u64 elapsed = 0;
+    while (elapsed < duration)
+    {
+        if (!PumpOutput(master, screen, duration - elapsed))
+            return;
+
+        elapsed = GetMonotonicTime() - start;
+    }
+}
+
+bool MeasureKeystroke(i32 master, VirtualScreen* screen, const char* key, u64* latency)
+{
+    VirtualScreen before = *screen;
+
+    u64 start = GetMonotonicTime();
+    if (write(master, key, GetStrLength(key)) < 0)
+        return false;
+
+    // A keystroke may be drawn over several frames, so the clock stops at the last frame that changed the
+    // screen once no further change has arrived for LATENCY_QUIET.
+    u64 changed = 0;
+    u64 now = start;
+    while (now - start < LATENCY_TIMEOUT)
+    {
+        u64 wait = (changed == 0) ? LATENCY_TIMEOUT - (now - start) : LATENCY_QUIET - Min(now - changed, LATENCY_QUIET);
+        u64 frames = screen->Frames;
+        bool pumped = PumpOutput(master, screen, wait);
+        now = GetMonotonicTime();
+
+        if (pumped && screen->Frames != frames && ScreensDiffer(&before, screen))
+        {
+            before = *screen;
+            changed = now;
+        }
+
+        if (changed != 0 && now - changed >= LATENCY_QUIET)
+            break;
+
+        if (!pumped && changed == 0)
+            return false;
+    }
+
+    if (changed == 0)
+        return false;
+
+    *latency = changed - start;
+    return true;
+}
+
+void SortSamples(u64* samples, usize count)
+{
+    for (usize index = 1; index < count; index += 1)
+    {
+        u64 value = samples[index];
+        usize position = index;
+        while (position > 0 && samples[position - 1] > value)
+        {
+            samples[position] = samples[position - 1];
+            position -= 1;
+        }
+
+        samples[position] = value;
+    }
+}
+
+void AppendPercentile(String* json, const char* name, u64* samples, usize count, usize percentile)
+{
+    usize index = (count * percentile + 99) / 100;
+    index = (index == 0) ? 0 : index - 1;
+
+    AppendStr(json, ",\"");
+    AppendStr(json, name);
+    AppendStr(json, "\":");
+    AppendUInt(json, (count == 0) ? 0 : samples[Min(index, count - 1)] / 1000);
+}
+
+void AppendScenarioJson(String* json, LatencyScenario* scenario)
+{
+    SortSamples(scenario->Samples, scenario->SampleCount);
+
+    u64 total = 0;
+    for (usize index = 0; index < scenario->SampleCount; index += 1)
+        total += scenario->Samples[index];
+
+    AppendStr(json, "{\"name\":\"");
+    AppendStr(json, scenario->Name);
+    AppendStr(json, "\",\"samples\":");
+    AppendUInt(json, scenario->SampleCount);
+    AppendStr(json, ",\"mean_us\":");
+    AppendUInt(json, (scenario->SampleCount == 0) ? 0 : total / scenario->SampleCount / 1000);
+    AppendPercentile(json, "min_us", scenario->Samples, scenario->SampleCount, 0);
+    AppendPercentile(json, "p50_us", scenario->Samples, scenario->SampleCount, 50);
+    AppendPercentile(json, "p90_us", scenario->Samples, scenario->SampleCount, 90);
+    AppendPercentile(json, "p99_us", scenario->Samples, scenario->SampleCount, 99);
+    AppendPercentile(json, "max_us", scenario->Samples, scenario->SampleCount, 100);
+    AppendChar(json, '}');
+}
+
+bool CreateLatencyFile(String* filepath)
+{
+    AppendStr(filepath, "/tmp/LieLatency-");
+    AppendUInt(filepath, (u64)getpid());
+    AppendStr(filepath, ".txt");
+
+    String content = EmptyString;
+    ExtendString(&content, 5000 * 80);
+    for (u64 row = 1; row <= 5000; row += 1)
+    {
+        AppendUInt(&content, row);
+        AppendStr(&content, ": Lorem ipsum dolor sit amet, consectetur adipiscing elit.\n");
+    }
+
+    bool status = WriteFile(ToStringView(filepath), ToStringView(&content));
+    FinalizeString(&content);
+    return status;
+}
+
+int main(int argc, const char* argv[])
+{
+    const char* executable = (argc > 1) ? argv[1] : LIE_EXECUTABLE;
+
+    String filepath = EmptyString;
+    if (!CreateLatencyFile(&filepath))
+    {
+        static const StringView fileError = AsStringView("Failed to create the latency file.\n");
+        WriteStdOut(fileError.Content, fileError.Length);
+        return 1;
+    }
+
+    struct winsize size = {.ws_row = SCREEN_HEIGHT, .ws_col = SCREEN_WIDTH};
+    i32 master = -1;
+    pid_t child = forkpty(&master, NULL, NULL, &size);
+    if (child < 0)
+    {
+        static const StringView forkError = AsStringView("Failed to spawn the editor on a pseudo-terminal.\n");
+        WriteStdOut(forkError.Content, forkError.Length);
+        return 1;
+    }
+
+    if (child == 0)
+    {
+        execl(executable, executable, filepath.Content, (char*)NULL);
+        _exit(127);
+    }
+
+    static VirtualScreen screen;
+    InitializeVirtualScreen(&screen);
+    DrainOutput(master, &screen, LATENCY_SETTLE);
+
+    // clang-format off
+    static LatencyScenario scenarios[] = {
+        {.Name = "cursor", .Keys = {"\x1B[B", "\x1B[C", "\x1B[A", "\x1B[D"}, .KeyCount = 4},
+        {.Name = "paging", .Keys = {"\x1B[6~", "\x1B[5~"}, .KeyCount = 2},
+        {.Name = "typing", .Setup = "\x05", .Keys = {"a", "b", "c", "d"}, .KeyCount = 4},
+    };
+    // clang-format on
+
+    bool failed = false;
+    usize scenarioCount = sizeof(scenarios) / sizeof(scenarios[0]);
+    for (usize index = 0; index < scenarioCount && !failed; index += 1)
+    {
+        LatencyScenario* scenario = &scenarios[index];
+        if (scenario->Setup != NULL)
+        {
+            failed = write(master, scenario->Setup, GetStrLength(scenario->Setup)) < 0;
+            DrainOutput(master, &screen, LATENCY_SETTLE);
+        }
+
+        for (usize sample = 0; sample < LATENCY_WARMUP + LATENCY_SAMPLES && !failed; sample += 1)
+        {
+            u64 latency;
+            if (!MeasureKeystroke(master, &screen, scenario->Keys[sample % scenario->KeyCount], &latency))
+            {
+                failed = true;
+                break;
+            }
+
+            if (sample >= LATENCY_WARMUP)
+            {
+                scenario->Samples[scenario->SampleCount] = latency;
+                scenario->SampleCount += 1;
+            }
+        }
+    }
+
+    static const char quit = '\x11';
+    if (write(master, &quit, 1) < 0 || failed)
+        kill(child, SIGTERM);
+
+    DrainOutput(master, &screen, LATENCY_SETTLE);
+    waitpid(child, NULL, 0);
+    close(master);
+    unlink(filepath.Content);
+
+    String json = EmptyString;
+    AppendStr(&json, "{\"executable\":\"");
+    AppendStr(&json, executable);
+    AppendStr(&json, "\",\"complete\":");
+    AppendStr(&json, failed ? "false" : "true");
+    AppendStr(&json, ",\"scenarios\":[");
+    for (usize index = 0; index < scenarioCount; index += 1)
+    {
+        if (index > 0)
+            AppendChar(&json, ',');
+
+        AppendScenarioJson(&json, &scenarios[index]);
+    }
+    AppendStr(&json, "]}\n");
+    WriteStdOut(json.Content, json.Length);
+
+    FinalizeString(&json);
+    FinalizeString(&filepath);
+    return failed ? 1 : 0;
+}
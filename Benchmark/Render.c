@@ -0,0 +1,178 @@
+#include <Editor.h>
+#include <Terminal.h>
+#include <IO.h>
+
+#include <unistd.h>
+
+#define BENCHMARK_WIDTH  120
+#define BENCHMARK_HEIGHT 40
+#define BENCHMARK_ROWS   1000000
+
+typedef struct BenchmarkResult
+{
+    u64 Frames;
+    u64 Bytes;
+    u64 EventNanoseconds;
+    u64 RenderNanoseconds;
+    u64 EncodeNanoseconds;
+} BenchmarkResult;
+
+bool CreateBenchmarkFile(String* filepath)
+{
+    AppendStr(filepath, "/tmp/LieBench-");
+    AppendUInt(filepath, (u64)getpid());
+    AppendStr(filepath, ".txt");
+
+    String content = EmptyString;
+    ExtendString(&content, (usize)BENCHMARK_ROWS * 192);
+    for (u64 row = 1; row <= BENCHMARK_ROWS; row += 1)
+    {
+        AppendUInt(&content, row);
+        AppendStr(&content, ": The quick brown fox jumps over the lazy dog while the editor keeps rendering.");
+        if (row % 7 == 0)
+            AppendStr(&content, " Some rows are longer than the screen so horizontal slicing is exercised too.");
+
+        AppendChar(&content, '\n');
+    }
+
+    bool status = WriteFile(ToStringView(filepath), ToStringView(&content));
+    FinalizeString(&content);
+    return status;
+}
+
+void RunScenario(const char* name, StringView filepath, Event* script, usize count, BenchmarkResult* result)
+{
+    EditorOptions options;
+    InitializeEditorOptions(&options);
+
+    Terminal* terminal = CreateHeadlessTerminal(BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+    Editor* editor = CreateEditor(terminal, &options);
+
+    String path = EmptyString;
+    AppendStringView(&path, filepath);
+    OpenEditorFile(editor, path);
+
+    for (usize index = 0; index < count; index += 1)
+        PushTerminalEvent(terminal, &script[index]);
+
+    RenderEditorFrame(editor);
+
+    TerminalStatistics before;
+    GetTerminalStatistics(terminal, &before);
+
+    MemoryClear(result, sizeof(BenchmarkResult));
+
+    Event event;
+    while (ReadEvent(terminal, &event))
+    {
+        u64 start = GetMonotonicTime();
+        HandleEditorEvent(editor, &event);
+        u64 middle = GetMonotonicTime();
+        RenderEditorFrame(editor);
+        u64 end = GetMonotonicTime();
+
+        result->EventNanoseconds += middle - start;
+        result->RenderNanoseconds += end - middle;
+    }
+
+    TerminalStatistics after;
+    GetTerminalStatistics(terminal, &after);
+    result->Frames = after.Frames - before.Frames;
+    result->Bytes = after.BytesWritten - before.BytesWritten;
+    result->EncodeNanoseconds = after.EncodeNanoseconds - before.EncodeNanoseconds;
+
+    DestroyEditor(editor);
+    FinalizeEditorOptions(&options);
+
+    String report = EmptyString;
+    AppendStr(&report, name);
+    AppendStr(&report, ": ");
+    AppendUInt(&report, result->Frames);
+    AppendStr(&report, " frames, ");
+    AppendUInt(&report, result->RenderNanoseconds / Max(result->Frames, 1));
+    AppendStr(&report, " ns/RefreshScreen (");
+    AppendUInt(&report, (result->RenderNanoseconds - result->EncodeNanoseconds) / Max(result->Frames, 1));
+    AppendStr(&report, " ns generating, ");
+    AppendUInt(&report, result->EncodeNanoseconds / Max(result->Frames, 1));
+    AppendStr(&report, " ns encoding), ");
+    AppendUInt(&report, result->Bytes / Max(result->Frames, 1));
+    AppendStr(&report, " bytes/frame, ");
+    AppendUInt(&report, result->EventNanoseconds / Max(result->Frames, 1));
+    AppendStr(&report, " ns/ProcessEvent\n");
+    WriteStdOut(report.Content, report.Length);
+    FinalizeString(&report);
+}
+
+Event* CreateScript(usize count)
+{
+    return (Event*)MemoryAllocate(count * sizeof(Event));
+}
+
+bool RunReplay(StringView replayPath, StringView filepath)
+{
+    EditorOptions options;
+    InitializeEditorOptions(&options);
+    AppendStringView(&options.ReplayPath, replayPath);
+    options.ReplaySpeed = REPLAY_SPEED_MAXIMUM;
+
+    Terminal* terminal = CreateHeadlessTerminal(BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+    Editor* editor = CreateEditor(terminal, &options);
+
+    String path = EmptyString;
+    AppendStringView(&path, filepath);
+    bool status = OpenEditorFile(editor, path) && RunEditor(editor);
+
+    DestroyEditor(editor);
+    FinalizeEditorOptions(&options);
+    return status;
+}
+
+int main(int argc, const char* argv[])
+{
+    static const StringView replayOption = AsStringView("--replay=");
+    if (argc == 3 && StringViewStartsWith(MakeStringViewFromStr(argv[1]), replayOption))
+    {
+        StringView replayPath = MakeStringViewFromStr(argv[1] + replayOption.Length);
+        return RunReplay(replayPath, MakeStringViewFromStr(argv[2])) ? 0 : 1;
+    }
+
+    String filepath = EmptyString;
+    if (!CreateBenchmarkFile(&filepath))
+    {
+        static const StringView fileError = AsStringView("Failed to create the benchmark file.\n");
+        WriteStdOut(fileError.Content, fileError.Length);
+        return 1;
+    }
+
+    BenchmarkResult result;
+    usize count = 20000;
+    Event* script = CreateScript(count + 2);
+
+    for (usize index = 0; index < count; index += 1)
+        MakeKeyEvent(&script[index], KEY_CODE_DOWN, KEY_MODIFIER_NONE, 0);
+    RunScenario("Scrolling", ToStringView(&filepath), script, count, &result);
+
+    for (usize index = 0; index < count; index += 1)
+        MakeKeyEvent(&script[index], KEY_CODE_PAGE_DOWN, KEY_MODIFIER_NONE, 0);
+    RunScenario("Paging", ToStringView(&filepath), script, count, &result);
+
+    static const StringView sentence = AsStringView("typing into a large file ");
+    MakeKeyEvent(&script[0], KEY_CODE_CHARACTER, KEY_MODIFIER_CONTROL, 'E');
+    for (usize index = 1; index <= count; index += 1)
+    {
+        if (index % 80 == 0)
+        {
+            MakeKeyEvent(&script[index], KEY_CODE_ENTER, KEY_MODIFIER_NONE, 0);
+            continue;
+        }
+
+        char character = sentence.Content[index % sentence.Length];
+        MakeKeyEvent(&script[index], KEY_CODE_CHARACTER, KEY_MODIFIER_NONE, (u8)character);
+    }
+    RunScenario("Typing", ToStringView(&filepath), script, count + 1, &result);
+
+    MemoryFree(script);
+    unlink(filepath.Content);
+    FinalizeString(&filepath);
+    return 0;
+}
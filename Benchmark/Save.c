@@ -0,0 +1,128 @@
+#include <Core.h>
+#include <Utility.h>
+#include <IO.h>
+#include <Save.h>
+
+#include <unistd.h>
+
+#define SAVE_ITERATIONS 20
+
+typedef struct SaveScenario
+{
+    const char* Name;
+    usize Rows;
+} SaveScenario;
+
+typedef struct SaveRows
+{
+    String* Values;
+    usize Count;
+    usize Bytes;
+} SaveRows;
+
+void CreateSaveRows(SaveRows* rows, usize count)
+{
+    rows->Values = (String*)MemoryAllocate(count * sizeof(String));
+    rows->Count = count;
+    rows->Bytes = 0;
+
+    for (usize index = 0; index < count; index += 1)
+    {
+        String* row = &rows->Values[index];
+        *row = EmptyString;
+        AppendStr(row, "setting.");
+        AppendUInt(row, index);
+        AppendStr(row, " = \"the quick brown fox jumps over the lazy dog\" # ");
+        AppendUInt(row, index * 2654435761u % 1000000);
+        rows->Bytes += row->Length + 1;
+    }
+}
+
+void DestroySaveRows(SaveRows* rows)
+{
+    for (usize index = 0; index < rows->Count; index += 1)
+        FinalizeString(&rows->Values[index]);
+
+    MemoryFree(rows->Values);
+}
+
+bool SaveRowsToFile(SaveRows* rows, StringView filepath, FileDurability durability)
+{
+    SaveJob* job = StartSave(filepath, durability, EmptyStringView, rows->Values, rows->Count);
+    return job != NULL && FinishSave(job);
+}
+
+void SortSaveSamples(u64* samples, usize count)
+{
+    for (usize index = 1; index < count; index += 1)
+    {
+        u64 value = samples[index];
+        usize position = index;
+        while (position > 0 && samples[position - 1] > value)
+        {
+            samples[position] = samples[position - 1];
+            position -= 1;
+        }
+
+        samples[position] = value;
+    }
+}
+
+void RunSaveScenario(SaveScenario* scenario, StringView filepath)
+{
+    static const char* durabilities[] = {"none", "data", "full"};
+
+    SaveRows rows;
+    CreateSaveRows(&rows, scenario->Rows);
+
+    for (usize durability = FILE_DURABILITY_NONE; durability <= FILE_DURABILITY_FULL; durability += 1)
+    {
+        u64 samples[SAVE_ITERATIONS];
+        u64 total = 0;
+        bool saved = true;
+        for (usize iteration = 0; iteration < SAVE_ITERATIONS; iteration += 1)
+        {
+            u64 start = GetMonotonicTime();
+            saved &= SaveRowsToFile(&rows, filepath, (FileDurability)durability);
+            samples[iteration] = GetMonotonicTime() - start;
+            total += samples[iteration];
+        }
+
+        SortSaveSamples(samples, SAVE_ITERATIONS);
+
+        String report = EmptyString;
+        AppendStr(&report, scenario->Name);
+        AppendStr(&report, " (");
+        AppendUInt(&report, rows.Bytes / 1024);
+        AppendStr(&report, " KB), durability ");
+        AppendStr(&report, durabilities[durability]);
+        AppendStr(&report, ": mean ");
+        AppendUInt(&report, total / SAVE_ITERATIONS / 1000);
+        AppendStr(&report, " us, median ");
+        AppendUInt(&report, samples[SAVE_ITERATIONS / 2] / 1000);
+        AppendStr(&report, " us, max ");
+        AppendUInt(&report, samples[SAVE_ITERATIONS - 1] / 1000);
+        AppendStr(&report, saved ? " us\n" : " us (failed)\n");
+        WriteStdOut(report.Content, report.Length);
+        FinalizeString(&report);
+    }
+
+    DestroySaveRows(&rows);
+}
+
+int main(int argc, const char* argv[])
+{
+    StringView filepath = (argc > 1) ? MakeStringViewFromStr(argv[1]) : AsStringView("LieSaveBench.txt");
+
+    SaveScenario scenarios[] = {
+        {.Name = "Config", .Rows = 64},
+        {.Name = "Source", .Rows = 20000},
+        {.Name = "Log", .Rows = 1000000},
+    };
+
+    for (usize index = 0; index < sizeof(scenarios) / sizeof(scenarios[0]); index += 1)
+        RunSaveScenario(&scenarios[index], filepath);
+
+    unlink(filepath.Content);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <Search.h>
+#include <Regex.h>
+#include <Thread.h>
+#include <IO.h>
+
+#define BENCHMARK_ROWS 1000000
+
+typedef struct BenchmarkRows
+{
+    String* Values;
+    usize Count;
+    usize Bytes;
+} BenchmarkRows;
+
+void CreateBenchmarkRows(BenchmarkRows* rows)
+{
+    static const char* levels[] = {"INFO ", "DEBUG", "WARN ", "INFO ", "ERROR", "INFO ", "DEBUG"};
+    static const char* users[] = {"alice@example.com", "bob@example.org", "carol@example.net", "dave@example.com"};
+
+    rows->Values = (String*)MemoryAllocate(BENCHMARK_ROWS * sizeof(String));
+    rows->Count = BENCHMARK_ROWS;
+    rows->Bytes = 0;
+
+    u64 seed = 0x9E3779B97F4A7C15;
+    for (usize index = 0; index < BENCHMARK_ROWS; index += 1)
+    {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        u64 random = seed >> 33;
+
+        String* row = &rows->Values[index];
+        *row = EmptyString;
+        ExtendString(row, 160);
+        AppendStr(row, "2024-05-01T12:");
+        AppendUInt(row, 10 + index % 50);
+        AppendStr(row, ":00.000Z ");
+        AppendStr(row, levels[random % 7]);
+        AppendStr(row, " [worker-");
+        AppendUInt(row, random % 16);
+        AppendStr(row, "] request id=");
+        AppendUInt(row, random);
+        AppendStr(row, " path=/api/v1/items/");
+        AppendUInt(row, index);
+        AppendStr(row, " took ");
+        AppendUInt(row, (random >> 8) % 2000);
+        AppendStr(row, " ms user=");
+        AppendStr(row, users[(random >> 4) % 4]);
+        rows->Bytes += row->Length + 1;
+    }
+}
+
+void DestroyBenchmarkRows(BenchmarkRows* rows)
+{
+    for (usize index = 0; index < rows->Count; index += 1)
+        FinalizeString(&rows->Values[index]);
+
+    MemoryFree(rows->Values);
+}
+
+void ReportSearch(const char* name, usize matches, u64 nanoseconds, usize bytes)
+{
+    String report = EmptyString;
+    AppendStr(&report, name);
+    AppendStr(&report, ": ");
+    AppendUInt(&report, matches);
+    AppendStr(&report, " matches, ");
+    AppendUInt(&report, nanoseconds / 1000000);
+    AppendStr(&report, " ms, ");
+    AppendUInt(&report, (u64)bytes * 1000 / Max(nanoseconds, 1));
+    AppendStr(&report, " MB/s\n");
+    WriteStdOut(report.Content, report.Length);
+    FinalizeString(&report);
+}
+
+void RunLiteralSearch(BenchmarkRows* rows, StringView needle)
+{
+    u64 start = GetMonotonicTime();
+    usize matches = 0;
+    for (usize index = 0; index < rows->Count; index += 1)
+        matches += CountSubstrings(ToStringView(&rows->Values[index]), needle);
+
+    u64 elapsed = GetMonotonicTime() - start;
+
+    String name = EmptyString;
+    AppendStr(&name, "Literal \"");
+    AppendStringView(&name, needle);
+    AppendStr(&name, "\" (1 thread)");
+    ReportSearch(name.Content, matches, elapsed, rows->Bytes);
+    FinalizeString(&name);
+}
+
+void RunRegexSearch(BenchmarkRows* rows, StringView pattern, ThreadPool* pool)
+{
+    Regex* regex = CreateRegex(pattern, NULL);
+    RegexMatches matches;
+    InitializeRegexMatches(&matches);
+
+    u64 start = GetMonotonicTime();
+    FindRegexMatches(regex, pool, rows->Values, rows->Count, &matches);
+    u64 elapsed = GetMonotonicTime() - start;
+
+    String name = EmptyString;
+    AppendStr(&name, "Regex \"");
+    AppendStringView(&name, pattern);
+    AppendStr(&name, "\" (");
+    AppendUInt(&name, GetThreadPoolSize(pool));
+    AppendStr(&name, GetThreadPoolSize(pool) == 1 ? " thread)" : " threads)");
+    ReportSearch(name.Content, matches.Count, elapsed, rows->Bytes);
+    FinalizeString(&name);
+
+    FinalizeRegexMatches(&matches);
+    DestroyRegex(regex);
+}
+
+int main()
+{
+    BenchmarkRows rows;
+    CreateBenchmarkRows(&rows);
+
+    ThreadPool* single = CreateThreadPool(1);
+    ThreadPool* parallel = CreateThreadPool(0);
+
+    static const StringView literals[] = {AsStringView("ERROR"), AsStringView("example.org")};
+    for (usize index = 0; index < sizeof(literals) / sizeof(literals[0]); index += 1)
+    {
+        RunLiteralSearch(&rows, literals[index]);
+        RunRegexSearch(&rows, literals[index], single);
+        RunRegexSearch(&rows, literals[index], parallel);
+    }
+
+    static const StringView patterns[] = {AsStringView("took 1[0-9]{3} ms"), AsStringView("user=[a-z]+@example\\.(com|net)$")};
+    for (usize index = 0; index < sizeof(patterns) / sizeof(patterns[0]); index += 1)
+    {
+        RunRegexSearch(&rows, patterns[index], single);
+        RunRegexSearch(&rows, patterns[index], parallel);
+    }
+
+    DestroyThreadPool(parallel);
+    DestroyThreadPool(single);
+    DestroyBenchmarkRows(&rows);
+    return 0;
+}
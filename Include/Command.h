@@ -2,7 +2,7 @@
 #define __LIE_COMMAND_H__
 
 #include <Core.h>
-#include <Queue.h>
+#include <Utility.h>
 
 typedef enum ColorKind
 {
@@ -62,6 +62,7 @@ typedef enum CommandKind
     COMMAND_CLEAR_LINE = 5,
     COMMAND_SET_FOREGROUND = 6,
     COMMAND_SET_BACKGROUND = 7,
+    COMMAND_PRINT_ROW = 8,
 } CommandKind;
 
 typedef enum ClearScreenMode
@@ -118,9 +119,22 @@ typedef struct Command
         {
             Color Value;
         } SetBackground;
+
+        struct PrintRowCommandData
+        {
+            u16 Y;
+            StringView Text;
+        } PrintRow;
     };
 } Command;
 
+typedef struct CommandStream
+{
+    usize Count;
+    usize Capacity;
+    Command* Values;
+} CommandStream;
+
 void MakePrintCommand(Command* command, StringView text);
 void MakeMoveCursorCommand(Command* command, u16 x, u16 y);
 void MakeHideCursorCommand(Command* command);
@@ -129,7 +143,13 @@ void MakeClearScreenCommand(Command* command, ClearScreenMode value);
 void MakeClearLineCommand(Command* command, ClearLineMode value);
 void MakeSetForegroundCommand(Command* command, Color value);
 void MakeSetBackgroundCommand(Command* command, Color value);
-
-DeclareQueue(CommandQueue, Command)
+void MakePrintRowCommand(Command* command, u16 y, StringView text);
+
+void InitializeCommandStream(CommandStream* stream, usize capacity);
+void FinalizeCommandStream(CommandStream* stream);
+void ReserveCommandStream(CommandStream* stream, usize count);
+Command* EmitCommand(CommandStream* stream);
+Command* EmitCommands(CommandStream* stream, usize count);
+void ClearCommandStream(CommandStream* stream);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef __LIE_DISPLAY_H__
+#define __LIE_DISPLAY_H__
+
+#include <Core.h>
+#include <Utility.h>
+#include <List.h>
+
+#define DISPLAY_DEFAULT_TAB_WIDTH   4
+#define DISPLAY_CHECKPOINT_INTERVAL 512
+#define DISPLAY_CACHE_LINES         256
+#define DISPLAY_UNBOUNDED           ((usize)-1)
+
+typedef struct DisplayCheckpoint
+{
+    usize Byte;
+    usize Column;
+} DisplayCheckpoint;
+
+DeclareList(DisplayCheckpoints, DisplayCheckpoint)
+
+typedef struct DisplayLine
+{
+    bool Used;
+    bool Complete;
+    usize Row;
+    usize Width;
+    DisplayCheckpoints Checkpoints;
+} DisplayLine;
+
+DeclareList(DisplayLines, DisplayLine)
+
+typedef struct DisplayCache
+{
+    usize TabWidth;
+    DisplayLines Lines;
+    usize NextEviction;
+} DisplayCache;
+
+void InitializeDisplayCache(DisplayCache* cache, usize tabWidth);
+void FinalizeDisplayCache(DisplayCache* cache);
+
+void InvalidateDisplayRow(DisplayCache* cache, usize rowIndex, usize byte);
+void InsertDisplayRow(DisplayCache* cache, usize rowIndex);
+void RemoveDisplayRow(DisplayCache* cache, usize rowIndex);
+void ClearDisplayCache(DisplayCache* cache);
+
+usize SkipPlainDisplayBytes(StringView row, usize byte, usize end);
+usize MeasureDisplayCharacter(DisplayCache* cache, StringView row, usize byte, usize column, usize* width);
+usize GetDisplayColumn(DisplayCache* cache, usize rowIndex, StringView row, usize byte);
+usize GetDisplayByte(DisplayCache* cache, usize rowIndex, StringView row, usize column);
+usize GetDisplayWidth(DisplayCache* cache, usize rowIndex, StringView row);
+
+#endif
\ No newline at end of file
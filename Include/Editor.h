@@ -2,8 +2,42 @@
 #define __LIE_EDITOR_H__
 
 #include <Utility.h>
+#include <Event.h>
+#include <Terminal.h>
+#include <IO.h>
 
-bool RunEditorWithNoFile();
-bool RunEditorWithFile(String filepath);
+typedef enum ReplaySpeed
+{
+    REPLAY_SPEED_RECORDED,
+    REPLAY_SPEED_MAXIMUM,
+} ReplaySpeed;
+
+typedef struct EditorOptions
+{
+    String RecordPath;
+    String ReplayPath;
+    ReplaySpeed ReplaySpeed;
+    usize TabWidth;
+    FileDurability Durability;
+    bool Follow;
+} EditorOptions;
+
+typedef struct Editor Editor;
+
+void InitializeEditorOptions(EditorOptions* options);
+void FinalizeEditorOptions(EditorOptions* options);
+
+Editor* CreateEditor(Terminal* terminal, EditorOptions* options);
+void DestroyEditor(Editor* editor);
+
+bool OpenEditorFile(Editor* editor, String filepath);
+bool RunEditor(Editor* editor);
+
+void RenderEditorFrame(Editor* editor);
+void HandleEditorEvent(Editor* editor, Event* event);
+
+bool RunEditorWithNoFile(EditorOptions* options);
+bool RunEditorWithStream(EditorOptions* options);
+bool RunEditorWithFile(String filepath, EditorOptions* options);
 
 #endif
\ No newline at end of file
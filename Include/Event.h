@@ -41,17 +41,18 @@ typedef enum KeyModifier
 typedef struct Event
 {
     EventKind Kind;
+    u64 Timestamp;
     union
     {
         struct KeyEventData
         {
             KeyCode Code;
             KeyModifier Modifiers;
-            char Value;
+            u32 Value;
         } Key;
     };
 } Event;
 
-void MakeKeyEvent(Event* event, KeyCode code, KeyModifier modifiers, char value);
+void MakeKeyEvent(Event* event, KeyCode code, KeyModifier modifiers, u32 value);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef __LIE_HISTORY_H__
+#define __LIE_HISTORY_H__
+
+#include <Core.h>
+#include <Utility.h>
+#include <List.h>
+
+#define HISTORY_DEFAULT_CAPACITY (16 * 1024 * 1024)
+#define HISTORY_GROUP_TIMEOUT    1000000000
+
+typedef enum HistoryOperationKind
+{
+    HISTORY_OPERATION_INSERT = 1,
+    HISTORY_OPERATION_DELETE = 2,
+    HISTORY_OPERATION_SPLIT = 3,
+    HISTORY_OPERATION_JOIN = 4,
+    HISTORY_OPERATION_REPLACE = 5,
+} HistoryOperationKind;
+
+typedef struct HistoryOperation
+{
+    HistoryOperationKind Kind;
+    usize Row;
+    usize Column;
+    StringView Bytes;
+    StringView Replacement;
+} HistoryOperation;
+
+DeclareList(HistoryOperations, HistoryOperation)
+
+typedef struct History
+{
+    String Journal;
+    usize Position;
+    usize Capacity;
+
+    bool Grouping;
+    usize LastRecord;
+    usize LastRow;
+    usize LastColumn;
+    u64 LastTime;
+
+    bool BatchStart;
+} History;
+
+void InitializeHistory(History* history, usize capacity);
+void FinalizeHistory(History* history);
+
+void RecordHistory(History* history, HistoryOperation* operation);
+void BreakHistoryGroup(History* history);
+
+void BeginHistoryBatch(History* history);
+void RecordHistoryBatch(History* history, HistoryOperation* operation);
+void EndHistoryBatch(History* history);
+
+bool UndoHistory(History* history, HistoryOperations* operations);
+bool RedoHistory(History* history, HistoryOperations* operations);
+
+#endif
\ No newline at end of file
@@ -12,5 +12,68 @@ bool WriteStdOut(const void* source, usize size);
 bool ReadFile(StringView filepath, String* destination);
 bool WriteFile(StringView filepath, StringView source);
 bool AppendFile(StringView filepath, StringView source);
+bool WritePrivateFile(StringView filepath, StringView source, StringView original, bool append);
+bool DeleteFile(StringView filepath);
+bool GetFileInfo(StringView filepath, u64* size, u64* modified);
+
+#define FILE_WRITER_BATCH 256
+
+typedef enum FileDurability
+{
+    FILE_DURABILITY_NONE,
+    FILE_DURABILITY_DATA,
+    FILE_DURABILITY_FULL,
+} FileDurability;
+
+typedef struct FileWriter
+{
+    i32 Handle;
+    bool Failed;
+    bool Replacing;
+    FileDurability Durability;
+    String Path;
+    String TemporaryPath;
+    usize Count;
+    StringView Views[FILE_WRITER_BATCH];
+} FileWriter;
+
+bool OpenFileWriter(FileWriter* writer, StringView filepath, FileDurability durability);
+void RestrictFileWriter(FileWriter* writer, StringView original);
+void WriteFileView(FileWriter* writer, StringView view);
+void FlushFileWriter(FileWriter* writer);
+bool CloseFileWriter(FileWriter* writer);
+
+#define FILE_WATCHER_READ_LIMIT (4 * 1024 * 1024)
+
+typedef enum FileChange
+{
+    FILE_CHANGE_NONE,
+    FILE_CHANGE_APPENDED,
+    FILE_CHANGE_TRUNCATED,
+} FileChange;
+
+typedef struct FileWatcher
+{
+    i32 Handle;
+    i32 Notify;
+    u64 Offset;
+    bool Pending;
+} FileWatcher;
+
+bool OpenFileWatcher(FileWatcher* watcher, StringView filepath, u64 offset);
+FileChange ReadFileChanges(FileWatcher* watcher, String* destination);
+void CloseFileWatcher(FileWatcher* watcher);
+
+#define STREAM_SPILL_CHUNK  (1024 * 1024)
+#define STREAM_MEMORY_LIMIT ((u64)1024 * 1024 * 1024)
+
+typedef struct StreamSpill StreamSpill;
+
+StreamSpill* StartStreamSpill();
+bool OpenSpillWatcher(StreamSpill* spill, FileWatcher* watcher);
+bool IsStreamSpillFinished(StreamSpill* spill);
+void StopStreamSpill(StreamSpill* spill);
+bool IsStreamSpillTruncated(StreamSpill* spill);
+bool FinishStreamSpill(StreamSpill* spill);
 
 #endif
\ No newline at end of file
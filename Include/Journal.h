@@ -0,0 +1,47 @@
+#ifndef __LIE_JOURNAL_H__
+#define __LIE_JOURNAL_H__
+
+#include <Core.h>
+#include <Utility.h>
+#include <List.h>
+#include <History.h>
+
+#define JOURNAL_FLUSH_NANOSECONDS 1000000000
+#define JOURNAL_FLUSH_SIZE        (64 * 1024)
+#define JOURNAL_CHECKPOINT_SIZE   (4 * 1024 * 1024)
+
+typedef enum JournalStatus
+{
+    JOURNAL_STATUS_NONE,
+    JOURNAL_STATUS_RECOVERED,
+    JOURNAL_STATUS_STALE,
+} JournalStatus;
+
+typedef struct JournalEdit
+{
+    HistoryOperationKind Kind;
+    usize Row;
+    usize Column;
+    usize Removed;
+    StringView Inserted;
+} JournalEdit;
+
+DeclareList(JournalEdits, JournalEdit)
+
+typedef struct Journal Journal;
+
+Journal* CreateJournal(StringView filepath, bool resume);
+void DestroyJournal(Journal* journal, bool discard);
+
+void AppendJournalEdit(Journal* journal, JournalEdit* edit);
+void AppendJournalOperation(Journal* journal, HistoryOperation* operation);
+void UpdateJournal(Journal* journal, String* rows, usize count);
+void PreserveJournalRow(Journal* journal, String* row);
+void CheckpointJournal(Journal* journal);
+
+u64 GetJournalEditCount(Journal* journal);
+void RebaseJournal(Journal* journal, u64 savedEdits);
+
+JournalStatus ReadJournal(StringView filepath, String* content, String* storage, JournalEdits* edits);
+
+#endif
\ No newline at end of file
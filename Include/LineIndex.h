@@ -0,0 +1,39 @@
+#ifndef __LIE_LINE_INDEX_H__
+#define __LIE_LINE_INDEX_H__
+
+#include <Core.h>
+#include <Utility.h>
+
+#define LINE_INDEX_SCAN_ROWS 1024
+
+typedef u64 (*LineIndexMeasure)(void* context, usize row);
+
+typedef struct LineIndex
+{
+    u64* Tree;
+    u64* Sizes;
+    usize Count;
+    usize Capacity;
+    usize Dirty;
+    u64 Total;
+    LineIndexMeasure Measure;
+    void* Context;
+    bool Stale;
+} LineIndex;
+
+void InitializeLineIndex(LineIndex* index, LineIndexMeasure measure, void* context);
+void FinalizeLineIndex(LineIndex* index);
+
+void RebuildLineIndex(LineIndex* index, usize rowCount);
+void UpdateLineIndex(LineIndex* index, usize row);
+void AppendLineIndex(LineIndex* index, usize rowCount);
+void InsertLineIndex(LineIndex* index, usize row);
+void RemoveLineIndex(LineIndex* index, usize row);
+void ResizeLineIndex(LineIndex* index, usize rowCount);
+void MoveLineIndex(LineIndex* index, usize from, usize to);
+
+u64 GetLineOffset(LineIndex* index, usize row);
+u64 GetLineIndexSize(LineIndex* index);
+usize FindLineAtOffset(LineIndex* index, u64 offset);
+
+#endif
\ No newline at end of file
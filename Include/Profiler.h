@@ -0,0 +1,25 @@
+#ifndef __LIE_PROFILER_H__
+#define __LIE_PROFILER_H__
+
+#include <Core.h>
+#include <Utility.h>
+
+#define PROFILER_DEFAULT_CAPACITY 65536
+#define PROFILER_EVENT_TEXT_SIZE  160
+
+typedef struct ProfileScope
+{
+    const char* Name;
+    u64 Start;
+} ProfileScope;
+
+void EnableProfiler(usize capacity);
+void DisableProfiler();
+bool IsProfilerEnabled();
+
+ProfileScope BeginProfileScope(const char* name);
+void EndProfileScope(ProfileScope scope);
+
+bool ExportProfilerTrace(StringView filepath);
+
+#endif
\ No newline at end of file
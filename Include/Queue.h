@@ -4,6 +4,8 @@
 #include <Core.h>
 #include <Utility.h>
 
+#include <stdatomic.h>
+
 #define DeclareQueue(Name, Type)                  \
     typedef struct Name                           \
     {                                             \
@@ -86,4 +88,75 @@
         queue->Count = 0;                                                                                                                    \
     }
 
+#define DeclareRingQueue(Name, Type)                    \
+    typedef struct Name                                 \
+    {                                                   \
+        _Atomic usize Head;                             \
+        u8 HeadPadding[64 - sizeof(usize)];             \
+        _Atomic usize Tail;                             \
+        u8 TailPadding[64 - sizeof(usize)];             \
+        usize Capacity;                                 \
+        Type* Values;                                   \
+    } Name;                                             \
+                                                        \
+    void Initialize##Name(Name* queue, usize capacity); \
+    void Finalize##Name(Name* queue);                   \
+    bool Push##Name(Name* queue, Type value);           \
+    bool Pop##Name(Name* queue, Type* value);           \
+    usize Count##Name(Name* queue);
+
+#define ImplementRingQueue(Name, Type)                                                \
+    void Initialize##Name(Name* queue, usize capacity)                                \
+    {                                                                                 \
+        atomic_init(&queue->Head, 0);                                                 \
+        atomic_init(&queue->Tail, 0);                                                 \
+        queue->Capacity = 1;                                                          \
+        while (queue->Capacity < capacity)                                            \
+        {                                                                             \
+            queue->Capacity *= 2;                                                     \
+        }                                                                             \
+        queue->Values = (Type*)MemoryAllocate(queue->Capacity * sizeof(Type));        \
+    }                                                                                 \
+                                                                                      \
+    void Finalize##Name(Name* queue)                                                  \
+    {                                                                                 \
+        MemoryFree(queue->Values);                                                    \
+        queue->Values = NULL;                                                         \
+    }                                                                                 \
+                                                                                      \
+    bool Push##Name(Name* queue, Type value)                                          \
+    {                                                                                 \
+        usize tail = atomic_load_explicit(&queue->Tail, memory_order_relaxed);        \
+        usize head = atomic_load_explicit(&queue->Head, memory_order_acquire);        \
+        if (tail - head == queue->Capacity)                                           \
+        {                                                                             \
+            return false;                                                             \
+        }                                                                             \
+                                                                                      \
+        queue->Values[tail & (queue->Capacity - 1)] = value;                          \
+        atomic_store_explicit(&queue->Tail, tail + 1, memory_order_release);          \
+        return true;                                                                  \
+    }                                                                                 \
+                                                                                      \
+    bool Pop##Name(Name* queue, Type* value)                                          \
+    {                                                                                 \
+        usize head = atomic_load_explicit(&queue->Head, memory_order_relaxed);        \
+        usize tail = atomic_load_explicit(&queue->Tail, memory_order_acquire);        \
+        if (head == tail)                                                             \
+        {                                                                             \
+            return false;                                                             \
+        }                                                                             \
+                                                                                      \
+        *value = queue->Values[head & (queue->Capacity - 1)];                         \
+        atomic_store_explicit(&queue->Head, head + 1, memory_order_release);          \
+        return true;                                                                  \
+    }                                                                                 \
+                                                                                      \
+    usize Count##Name(Name* queue)                                                    \
+    {                                                                                 \
+        usize head = atomic_load_explicit(&queue->Head, memory_order_acquire);        \
+        usize tail = atomic_load_explicit(&queue->Tail, memory_order_acquire);        \
+        return tail - head;                                                           \
+    }
+
 #endif
\ No newline at end of file
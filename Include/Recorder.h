@@ -0,0 +1,19 @@
+#ifndef __LIE_RECORDER_H__
+#define __LIE_RECORDER_H__
+
+#include <Core.h>
+#include <Event.h>
+#include <List.h>
+
+typedef struct RecordedEvent
+{
+    u64 Time;
+    Event Event;
+} RecordedEvent;
+
+DeclareList(RecordedEvents, RecordedEvent)
+
+bool SaveRecordedEvents(StringView filepath, RecordedEvents* events);
+bool LoadRecordedEvents(StringView filepath, RecordedEvents* events);
+
+#endif
\ No newline at end of file
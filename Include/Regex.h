@@ -0,0 +1,34 @@
+#ifndef __LIE_REGEX_H__
+#define __LIE_REGEX_H__
+
+#include <Core.h>
+#include <Utility.h>
+#include <List.h>
+#include <Thread.h>
+
+#define REGEX_DFA_STATE_LIMIT 4096
+#define REGEX_REPEAT_LIMIT    1000
+#define REGEX_CHUNK_ROWS      4096
+
+typedef struct RegexMatch
+{
+    usize Row;
+    usize Column;
+    usize Length;
+} RegexMatch;
+
+DeclareList(RegexMatches, RegexMatch);
+
+typedef struct Regex Regex;
+typedef struct RegexMatcher RegexMatcher;
+
+Regex* CreateRegex(StringView pattern, String* error);
+void DestroyRegex(Regex* regex);
+
+RegexMatcher* CreateRegexMatcher(Regex* regex);
+void DestroyRegexMatcher(RegexMatcher* matcher);
+
+bool FindRegexInLine(RegexMatcher* matcher, StringView line, usize from, usize* start, usize* end);
+void FindRegexMatches(Regex* regex, ThreadPool* pool, String* rows, usize rowCount, RegexMatches* matches);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef __LIE_SAVE_H__
+#define __LIE_SAVE_H__
+
+#include <Core.h>
+#include <Utility.h>
+#include <IO.h>
+
+#define SAVE_BATCH_SIZE (64 * 1024)
+
+typedef struct SaveJob SaveJob;
+
+SaveJob* StartSave(StringView filepath, FileDurability durability, StringView prefix, String* rows, usize count);
+SaveJob* StartPrivateSave(StringView filepath, FileDurability durability, StringView original, StringView prefix, String* rows, usize count);
+void PreserveSavedRow(SaveJob* job, String* row);
+
+bool IsSaveFinished(SaveJob* job);
+bool WaitForSave(SaveJob* job, u64 timeout);
+usize GetSaveProgress(SaveJob* job);
+bool FinishSave(SaveJob* job);
+
+#endif
\ No newline at end of file
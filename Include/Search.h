@@ -0,0 +1,10 @@
+#ifndef __LIE_SEARCH_H__
+#define __LIE_SEARCH_H__
+
+#include <Core.h>
+#include <Utility.h>
+
+isize FindSubstring(StringView haystack, StringView needle);
+usize CountSubstrings(StringView haystack, StringView needle);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef __LIE_SYNTAX_H__
+#define __LIE_SYNTAX_H__
+
+#include <Core.h>
+#include <Utility.h>
+#include <List.h>
+#include <Command.h>
+
+typedef enum SyntaxState
+{
+    SYNTAX_STATE_NORMAL = 0,
+    SYNTAX_STATE_COMMENT = 1,
+    SYNTAX_STATE_PREPROCESSOR = 2,
+} SyntaxState;
+
+typedef enum SyntaxStyle
+{
+    SYNTAX_STYLE_NORMAL = 0,
+    SYNTAX_STYLE_KEYWORD = 1,
+    SYNTAX_STYLE_TYPE = 2,
+    SYNTAX_STYLE_NUMBER = 3,
+    SYNTAX_STYLE_STRING = 4,
+    SYNTAX_STYLE_COMMENT = 5,
+    SYNTAX_STYLE_PREPROCESSOR = 6,
+} SyntaxStyle;
+
+typedef struct SyntaxRun
+{
+    usize Start;
+    usize End;
+    SyntaxStyle Style;
+} SyntaxRun;
+
+DeclareList(SyntaxRuns, SyntaxRun)
+
+typedef struct SyntaxCache
+{
+    bool Enabled;
+    u8* States;
+    usize Capacity;
+    usize Known;
+    usize Valid;
+    usize DirtyRow;
+    SyntaxRuns Runs;
+} SyntaxCache;
+
+void InitializeSyntaxCache(SyntaxCache* cache);
+void FinalizeSyntaxCache(SyntaxCache* cache);
+
+bool IsSyntaxPath(StringView path);
+Color GetSyntaxColor(SyntaxStyle style);
+
+SyntaxState LexSyntaxLine(StringView line, SyntaxState state, SyntaxRuns* runs);
+
+void InvalidateSyntaxRow(SyntaxCache* cache, usize row);
+void InsertSyntaxRow(SyntaxCache* cache, usize row);
+void RemoveSyntaxRow(SyntaxCache* cache, usize row);
+void InvalidateSyntaxFrom(SyntaxCache* cache, usize row);
+
+void PrepareSyntax(SyntaxCache* cache, String* rows, usize rowCount, usize endRow);
+SyntaxState GetSyntaxStartState(SyntaxCache* cache, usize row);
+
+#endif
\ No newline at end of file
@@ -7,9 +7,29 @@
 
 typedef struct Terminal Terminal;
 
+typedef struct TerminalStatistics
+{
+    u64 Frames;
+    u64 DroppedFrames;
+    u64 BytesWritten;
+    u64 LastFrameBytes;
+    u64 EncodeNanoseconds;
+    u64 LastWriteNanoseconds;
+    u64 PendingBytes;
+    u64 FrameInterval;
+} TerminalStatistics;
+
 Terminal* CreateTerminal();
 void DestroyTerminal(Terminal* terminal);
 
+#if defined(LIE_TERMINAL_HEADLESS)
+Terminal* CreateHeadlessTerminal(u16 width, u16 height);
+void PushTerminalEvent(Terminal* terminal, Event* event);
+StringView GetTerminalFrame(Terminal* terminal);
+#endif
+
+bool IsTerminalInteractive(Terminal* terminal);
+
 void EnableRawMode(Terminal* terminal);
 void DisableRawMode(Terminal* terminal);
 
@@ -20,7 +40,10 @@ bool GetTerminalSize(Terminal* terminal, u16* width, u16* height);
 bool GetCursorPosition(Terminal* terminal, u16* x, u16* y);
 
 bool ReadEvent(Terminal* terminal, Event* event);
+usize GetPendingEventCount(Terminal* terminal);
 
-void ProcessCommandQueue(Terminal* terminal, CommandQueue* queue);
+void EncodeCommandStream(CommandStream* stream, String* out);
+void ProcessCommandStream(Terminal* terminal, CommandStream* stream);
+void GetTerminalStatistics(Terminal* terminal, TerminalStatistics* statistics);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef __LIE_THREAD_H__
+#define __LIE_THREAD_H__
+
+#include <Core.h>
+#include <Utility.h>
+
+typedef struct ThreadPool ThreadPool;
+typedef void (*ThreadTask)(void* context, usize index);
+
+typedef struct ThreadLock ThreadLock;
+typedef struct BackgroundThread BackgroundThread;
+typedef void (*BackgroundTask)(void* context);
+
+ThreadPool* CreateThreadPool(usize threadCount);
+void DestroyThreadPool(ThreadPool* pool);
+
+usize GetProcessorCount();
+usize GetThreadPoolSize(ThreadPool* pool);
+void RunThreadPool(ThreadPool* pool, ThreadTask task, void* context, usize count);
+
+ThreadLock* CreateThreadLock();
+void DestroyThreadLock(ThreadLock* lock);
+void AcquireThreadLock(ThreadLock* lock);
+void ReleaseThreadLock(ThreadLock* lock);
+
+BackgroundThread* StartBackgroundThread(BackgroundTask task, void* context);
+void JoinBackgroundThread(BackgroundThread* thread);
+
+#endif
\ No newline at end of file
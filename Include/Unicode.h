@@ -0,0 +1,19 @@
+#ifndef __LIE_UNICODE_H__
+#define __LIE_UNICODE_H__
+
+#include <Core.h>
+#include <Utility.h>
+
+#define UNICODE_REPLACEMENT_CHARACTER 0xFFFD
+
+usize DecodeUtf8(const char* bytes, usize length, u32* codepoint);
+usize EncodeUtf8(u32 codepoint, char* bytes);
+usize GetUtf8SequenceLength(char lead);
+usize ValidateUtf8(StringView text);
+
+usize FindPreviousCodepoint(StringView text, usize byte);
+usize FindNextCodepoint(StringView text, usize byte);
+
+usize GetCodepointWidth(u32 codepoint);
+
+#endif
\ No newline at end of file
@@ -6,12 +6,53 @@
 #define Min(left, right) ((left) < (right) ? (left) : (right))
 #define Max(left, right) ((left) > (right) ? (left) : (right))
 
-void* MemoryAllocate(usize size);
+#define MEMORY_SIZE_CLASS_COUNT 24
+#define MEMORY_CALL_SITE_COUNT  256
+
+typedef struct MemoryCallSite
+{
+    const char* File;
+    u32 Line;
+    u64 Allocations;
+    usize LiveBytes;
+} MemoryCallSite;
+
+typedef struct MemoryStatistics
+{
+    usize LiveBytes;
+    usize PeakBytes;
+    u64 Allocations;
+    u64 Frees;
+    u64 SizeClasses[MEMORY_SIZE_CLASS_COUNT];
+} MemoryStatistics;
+
+void* AllocatePages(usize size);
+void FreePages(void* pages, usize size);
+
+void LockMemory();
+void UnlockMemory();
+
+void* MemoryAllocateAt(usize size, const char* file, u32 line);
 void MemoryFree(void* source);
 
+#if defined(LIE_DEBUG)
+#define MemoryAllocate(size) MemoryAllocateAt(size, __FILE__, __LINE__)
+#define DebugAssert(condition) ((condition) ? (void)0 : __builtin_trap())
+#else
+#define MemoryAllocate(size) MemoryAllocateAt(size, NULL, 0)
+#define DebugAssert(condition) ((void)0)
+#endif
+
+void GetMemoryStatistics(MemoryStatistics* statistics);
+usize GetMemoryCallSites(MemoryCallSite* sites, usize capacity);
+
 void MemoryClear(void* destination, usize size);
 void MemorySet(void* destination, u8 value, usize size);
 void MemoryCopy(void* destination, const void* source, usize size);
+bool MemoryEquals(const void* left, const void* right, usize size);
+
+u64 GetMonotonicTime();
+void SleepFor(u64 nanoseconds);
 
 
 typedef struct String
@@ -45,12 +86,20 @@ void AppendStr(String* string, const char* str);
 void AppendString(String* string, String* other);
 void AppendStringView(String* string, StringView view);
 void AppendUInt(String* string, u64 value);
+void AppendByteSize(String* string, u64 bytes);
+void AppendMemoryStatistics(String* string);
+void AppendMemoryReport(String* string);
 
 void InsertChar(String* string, usize index, char c);
+void InsertStringView(String* string, usize index, StringView view);
 
 #define AsStringView(str) ((StringView){.Length = sizeof(str) - 1, .Content = str})
 StringView ToStringView(String* string);
 StringView MakeStringView(String* string, usize start, usize end);
+StringView MakeStringViewFromStr(const char* str);
+
+bool StringViewEquals(StringView left, StringView right);
+bool StringViewStartsWith(StringView view, StringView prefix);
 
 bool TryParseUInt(StringView view, u64* value);
 
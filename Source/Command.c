@@ -50,4 +50,59 @@ void MakeSetBackgroundCommand(Command* command, Color value)
     command->SetBackground.Value = value;
 }
 
-ImplementQueue(CommandQueue, Command)
+void MakePrintRowCommand(Command* command, u16 y, StringView text)
+{
+    command->Kind = COMMAND_PRINT_ROW;
+    command->PrintRow.Y = y;
+    command->PrintRow.Text = text;
+}
+
+void InitializeCommandStream(CommandStream* stream, usize capacity)
+{
+    stream->Count = 0;
+    stream->Capacity = capacity;
+    stream->Values = (Command*)MemoryAllocate(capacity * sizeof(Command));
+}
+
+void FinalizeCommandStream(CommandStream* stream)
+{
+    MemoryFree(stream->Values);
+    stream->Values = NULL;
+}
+
+void ReserveCommandStream(CommandStream* stream, usize count)
+{
+    if (stream->Count + count <= stream->Capacity)
+        return;
+
+    usize capacity = stream->Capacity * 2;
+    while (capacity < stream->Count + count)
+        capacity *= 2;
+
+    Command* values = (Command*)MemoryAllocate(capacity * sizeof(Command));
+    MemoryCopy(values, stream->Values, stream->Count * sizeof(Command));
+    MemoryFree(stream->Values);
+    stream->Capacity = capacity;
+    stream->Values = values;
+}
+
+Command* EmitCommand(CommandStream* stream)
+{
+    DebugAssert(stream->Count < stream->Capacity);
+    Command* command = &stream->Values[stream->Count];
+    stream->Count += 1;
+    return command;
+}
+
+Command* EmitCommands(CommandStream* stream, usize count)
+{
+    DebugAssert(stream->Count + count <= stream->Capacity);
+    Command* commands = &stream->Values[stream->Count];
+    stream->Count += count;
+    return commands;
+}
+
+void ClearCommandStream(CommandStream* stream)
+{
+    stream->Count = 0;
+}
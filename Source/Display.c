@@ -0,0 +1,316 @@
+#include <Display.h>
+#include <Unicode.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+ImplementList(DisplayCheckpoints, DisplayCheckpoint)
+ImplementList(DisplayLines, DisplayLine)
+
+void InitializeDisplayCache(DisplayCache* cache, usize tabWidth)
+{
+    cache->TabWidth = tabWidth;
+    InitializeDisplayLines(&cache->Lines);
+    cache->NextEviction = 0;
+}
+
+void FinalizeDisplayCache(DisplayCache* cache)
+{
+    for (usize index = 0; index < cache->Lines.Count; index += 1)
+        FinalizeDisplayCheckpoints(&cache->Lines.Values[index].Checkpoints);
+
+    FinalizeDisplayLines(&cache->Lines);
+}
+
+DisplayLine* FindDisplayLine(DisplayCache* cache, usize rowIndex)
+{
+    for (usize index = 0; index < cache->Lines.Count; index += 1)
+    {
+        DisplayLine* line = &cache->Lines.Values[index];
+        if (line->Used && line->Row == rowIndex)
+            return line;
+    }
+
+    return NULL;
+}
+
+void ResetDisplayLine(DisplayLine* line, usize rowIndex)
+{
+    line->Used = true;
+    line->Complete = false;
+    line->Row = rowIndex;
+    line->Width = 0;
+    ClearDisplayCheckpoints(&line->Checkpoints);
+    AddToDisplayCheckpoints(&line->Checkpoints, (DisplayCheckpoint){.Byte = 0, .Column = 0});
+}
+
+DisplayLine* AcquireDisplayLine(DisplayCache* cache, usize rowIndex)
+{
+    DisplayLine* line = FindDisplayLine(cache, rowIndex);
+    if (line != NULL)
+        return line;
+
+    for (usize index = 0; index < cache->Lines.Count; index += 1)
+    {
+        if (!cache->Lines.Values[index].Used)
+        {
+            line = &cache->Lines.Values[index];
+            break;
+        }
+    }
+
+    if (line == NULL && cache->Lines.Count < DISPLAY_CACHE_LINES)
+    {
+        DisplayLine empty = {0};
+        InitializeDisplayCheckpoints(&empty.Checkpoints);
+        AddToDisplayLines(&cache->Lines, empty);
+        line = &cache->Lines.Values[cache->Lines.Count - 1];
+    }
+
+    if (line == NULL)
+    {
+        line = &cache->Lines.Values[cache->NextEviction];
+        cache->NextEviction = (cache->NextEviction + 1) % DISPLAY_CACHE_LINES;
+    }
+
+    ResetDisplayLine(line, rowIndex);
+    return line;
+}
+
+void InvalidateDisplayRow(DisplayCache* cache, usize rowIndex, usize byte)
+{
+    DisplayLine* line = FindDisplayLine(cache, rowIndex);
+    if (line == NULL)
+        return;
+
+    DisplayCheckpoints* checkpoints = &line->Checkpoints;
+    while (checkpoints->Count > 1 && checkpoints->Values[checkpoints->Count - 1].Byte > byte)
+        checkpoints->Count -= 1;
+
+    line->Complete = false;
+}
+
+void InsertDisplayRow(DisplayCache* cache, usize rowIndex)
+{
+    for (usize index = 0; index < cache->Lines.Count; index += 1)
+    {
+        DisplayLine* line = &cache->Lines.Values[index];
+        if (line->Used && line->Row >= rowIndex)
+            line->Row += 1;
+    }
+}
+
+void RemoveDisplayRow(DisplayCache* cache, usize rowIndex)
+{
+    for (usize index = 0; index < cache->Lines.Count; index += 1)
+    {
+        DisplayLine* line = &cache->Lines.Values[index];
+        if (!line->Used || line->Row < rowIndex)
+            continue;
+
+        if (line->Row == rowIndex)
+            line->Used = false;
+        else
+            line->Row -= 1;
+    }
+}
+
+void ClearDisplayCache(DisplayCache* cache)
+{
+    for (usize index = 0; index < cache->Lines.Count; index += 1)
+        cache->Lines.Values[index].Used = false;
+}
+
+usize MeasureDisplayCharacter(DisplayCache* cache, StringView row, usize byte, usize column, usize* width)
+{
+    char character = row.Content[byte];
+    if (character == '\t')
+    {
+        *width = cache->TabWidth - column % cache->TabWidth;
+        return 1;
+    }
+
+    if ((u8)character < 0x80)
+    {
+        *width = 1;
+        return 1;
+    }
+
+    u32 codepoint;
+    usize size = DecodeUtf8(row.Content + byte, row.Length - byte, &codepoint);
+    *width = GetCodepointWidth(codepoint);
+    return size;
+}
+
+usize SkipPlainDisplayBytes(StringView row, usize byte, usize end)
+{
+#if defined(__SSE2__)
+    __m128i tabs = _mm_set1_epi8('\t');
+    for (; byte + 16 <= end; byte += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(row.Content + byte));
+        u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(block, _mm_cmpeq_epi8(block, tabs)));
+        if (mask != 0)
+            return byte + (usize)__builtin_ctz(mask);
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t tabs = vdupq_n_u8('\t');
+    uint8x16_t highs = vdupq_n_u8(0x80);
+    for (; byte + 16 <= end; byte += 16)
+    {
+        uint8x16_t block = vld1q_u8((const u8*)(row.Content + byte));
+        uint8x16_t special = vorrq_u8(vcgeq_u8(block, highs), vceqq_u8(block, tabs));
+        u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+        if (mask != 0)
+            return byte + (usize)__builtin_ctzll(mask) / 4;
+    }
+#endif
+
+    while (byte < end)
+    {
+        char character = row.Content[byte];
+        if ((u8)character >= 0x80 || character == '\t')
+            break;
+
+        byte += 1;
+    }
+
+    return byte;
+}
+
+usize ScanDisplayColumns(DisplayCache* cache, StringView row, usize* byte, usize column, usize end)
+{
+    usize current = *byte;
+    while (current < end)
+    {
+        usize plain = SkipPlainDisplayBytes(row, current, end);
+        column += plain - current;
+        current = plain;
+        if (current >= end)
+            break;
+
+        usize width;
+        current += MeasureDisplayCharacter(cache, row, current, column, &width);
+        column += width;
+    }
+
+    *byte = current;
+    return column;
+}
+
+void ExtendDisplayLine(DisplayCache* cache, DisplayLine* line, StringView row, usize byte, usize column)
+{
+    DisplayCheckpoints* checkpoints = &line->Checkpoints;
+    while (!line->Complete)
+    {
+        DisplayCheckpoint last = checkpoints->Values[checkpoints->Count - 1];
+        if (last.Byte > byte || last.Column > column)
+            break;
+
+        usize current = last.Byte;
+        usize end = Min(last.Byte + DISPLAY_CHECKPOINT_INTERVAL, row.Length);
+        usize currentColumn = ScanDisplayColumns(cache, row, &current, last.Column, end);
+        if (current >= row.Length)
+        {
+            line->Complete = true;
+            line->Width = currentColumn;
+        }
+        else
+        {
+            AddToDisplayCheckpoints(checkpoints, (DisplayCheckpoint){.Byte = current, .Column = currentColumn});
+        }
+    }
+}
+
+DisplayCheckpoint FindDisplayCheckpoint(DisplayCache* cache, usize rowIndex, StringView row, usize byte, usize column)
+{
+    DisplayCheckpoint start = {.Byte = 0, .Column = 0};
+    if (row.Length < DISPLAY_CHECKPOINT_INTERVAL)
+        return start;
+
+    DisplayLine* line = AcquireDisplayLine(cache, rowIndex);
+    ExtendDisplayLine(cache, line, row, byte, column);
+
+    DisplayCheckpoints* checkpoints = &line->Checkpoints;
+    usize low = 1, high = checkpoints->Count;
+    while (low < high)
+    {
+        usize middle = low + (high - low) / 2;
+        DisplayCheckpoint* checkpoint = &checkpoints->Values[middle];
+        if (checkpoint->Byte <= byte && checkpoint->Column <= column)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return checkpoints->Values[low - 1];
+}
+
+usize GetDisplayColumn(DisplayCache* cache, usize rowIndex, StringView row, usize byte)
+{
+    byte = Min(byte, row.Length);
+    DisplayCheckpoint checkpoint = FindDisplayCheckpoint(cache, rowIndex, row, byte, DISPLAY_UNBOUNDED);
+
+    usize current = checkpoint.Byte;
+    usize column = checkpoint.Column;
+    while (current < byte)
+    {
+        usize plain = SkipPlainDisplayBytes(row, current, byte);
+        column += plain - current;
+        current = plain;
+        if (current >= byte)
+            break;
+
+        usize width;
+        usize size = MeasureDisplayCharacter(cache, row, current, column, &width);
+        if (current + size > byte)
+            break;
+
+        current += size;
+        column += width;
+    }
+
+    return column;
+}
+
+usize GetDisplayByte(DisplayCache* cache, usize rowIndex, StringView row, usize column)
+{
+    DisplayCheckpoint checkpoint = FindDisplayCheckpoint(cache, rowIndex, row, DISPLAY_UNBOUNDED, column);
+
+    usize current = checkpoint.Byte;
+    usize currentColumn = checkpoint.Column;
+    while (current < row.Length)
+    {
+        usize plain = SkipPlainDisplayBytes(row, current, Min(row.Length, current + (column - currentColumn)));
+        currentColumn += plain - current;
+        current = plain;
+        if (current >= row.Length)
+            break;
+
+        usize width;
+        usize size = MeasureDisplayCharacter(cache, row, current, currentColumn, &width);
+        if (currentColumn + width > column)
+            break;
+
+        current += size;
+        currentColumn += width;
+    }
+
+    return current;
+}
+
+usize GetDisplayWidth(DisplayCache* cache, usize rowIndex, StringView row)
+{
+    DisplayLine* line = (row.Length < DISPLAY_CHECKPOINT_INTERVAL) ? NULL : FindDisplayLine(cache, rowIndex);
+    if (line == NULL)
+    {
+        usize current = 0;
+        return ScanDisplayColumns(cache, row, &current, 0, row.Length);
+    }
+
+    ExtendDisplayLine(cache, line, row, DISPLAY_UNBOUNDED, DISPLAY_UNBOUNDED);
+    return line->Width;
+}
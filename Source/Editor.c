@@ -2,23 +2,131 @@
 #include <List.h>
 #include <IO.h>
 #include <Terminal.h>
+#include <Profiler.h>
+#include <Recorder.h>
+#include <History.h>
+#include <LineIndex.h>
+#include <Display.h>
+#include <Unicode.h>
+#include <Syntax.h>
+#include <Search.h>
+#include <Regex.h>
+#include <Thread.h>
+#include <Save.h>
+#include <Journal.h>
+
+#define REPLAY_IDLE_NANOSECONDS 100000000
+#define EDITOR_EVENT_BATCH      256
+#define EDITOR_FRAME_COMMANDS   32
+#define EDITOR_ROW_COMMANDS_PER_BYTE 8
+#define SEARCH_SLICE_NANOSECONDS 4000000
+#define SEARCH_CLOCK_INTERVAL    256
+#define SAVE_FOREGROUND_NANOSECONDS 20000000
+#define FOLLOW_SLICE_NANOSECONDS 50000000
 
 DeclareList(Rows, String);
 ImplementList(Rows, String);
 
+typedef enum EditorRowKind
+{
+    EDITOR_ROW_UNKNOWN,
+    EDITOR_ROW_PLAIN,
+    EDITOR_ROW_MIXED,
+} EditorRowKind;
+
+DeclareList(EditorRowKinds, u8);
+ImplementList(EditorRowKinds, u8);
+
 typedef enum EditorMode
 {
     EDITOR_MODE_VIEW,
     EDITOR_MODE_EDIT,
 } EditorMode;
 
-typedef struct Editor
+typedef struct EditorSearch
+{
+    String Query;
+    bool Scanning;
+    bool Prompting;
+
+    usize OriginRow;
+    usize OriginColumn;
+
+    usize ScanRow;
+    usize ScannedRows;
+    usize Matches;
+
+    bool Found;
+    bool Wrapped;
+    usize WrappedRow;
+    usize WrappedColumn;
+
+    Regex* Regex;
+    RegexMatcher* Matcher;
+    RegexMatches RegexMatches;
+    bool RegexStale;
+} EditorSearch;
+
+typedef struct EditorCursor
+{
+    usize Row;
+    usize Column;
+} EditorCursor;
+
+DeclareList(EditorCursors, EditorCursor);
+ImplementList(EditorCursors, EditorCursor);
+
+DeclareList(EditorCursorPads, u8);
+ImplementList(EditorCursorPads, u8);
+
+typedef struct EditorSlice
+{
+    usize Row;
+    usize Start;
+    usize End;
+    usize FirstColumn;
+    usize LastColumn;
+    bool Plain;
+
+    usize Byte;
+    usize Column;
+} EditorSlice;
+
+typedef bool (*EditorPromptCallback)(Editor* editor, StringView input, bool changed);
+
+struct Editor
 {
     Terminal* Terminal;
-    CommandQueue Commands;
+    CommandStream Commands;
+    ThreadPool* Workers;
+
+    EditorOptions* Options;
+    RecordedEvents Recording;
+    usize ReplayIndex;
+    u64 StartTime;
 
     Rows Rows;
+    EditorRowKinds RowKinds;
+    LineIndex LineIndex;
+    LineIndex WrapIndex;
+    DisplayCache Display;
+    SyntaxCache Syntax;
     String Filepath;
+    SaveJob* Save;
+    u64 SaveEdits;
+    Journal* Journal;
+    FileWatcher Watcher;
+    StreamSpill* Stream;
+    String Followed;
+
+    History History;
+    HistoryOperations HistoryOperations;
+
+    EditorSearch Search;
+
+    EditorCursors Cursors;
+    EditorCursors CursorJoins;
+    EditorCursorPads CursorPads;
 
     bool Running;
     EditorMode Mode;
@@ -32,21 +140,75 @@ typedef struct Editor
     u16 FixedCursorX;
     u16 FixedCursorY;
 
-    u16 OffsetX;
-    u16 OffsetY;
+    usize OffsetX;
+    usize OffsetY;
+    usize ScrollX;
+
+    bool SoftWrap;
+    usize OffsetSegment;
 
     String Status;
     u16 StatusTimeout;
     bool IsErrorStatus;
-} Editor;
 
-void InitializeEditor(Editor* editor)
+    String InputStatus;
+    String PromptInfo;
+};
+
+void InitializeEditorOptions(EditorOptions* options)
+{
+    options->RecordPath = EmptyString;
+    options->ReplayPath = EmptyString;
+    options->ReplaySpeed = REPLAY_SPEED_RECORDED;
+    options->TabWidth = DISPLAY_DEFAULT_TAB_WIDTH;
+    options->Durability = FILE_DURABILITY_FULL;
+    options->Follow = false;
+}
+
+void FinalizeEditorOptions(EditorOptions* options)
+{
+    FinalizeString(&options->RecordPath);
+    FinalizeString(&options->ReplayPath);
+}
+
+u64 MeasureRowBytes(void* context, usize row);
+u64 MeasureRowLines(void* context, usize row);
+
+void InitializeEditor(Editor* editor, Terminal* terminal, EditorOptions* options)
 {
-    editor->Terminal = CreateTerminal();
-    InitializeCommandQueue(&editor->Commands);
+    editor->Terminal = terminal;
+    InitializeCommandStream(&editor->Commands, EDITOR_FRAME_COMMANDS * 8);
+    editor->Workers = NULL;
+
+    editor->Options = options;
+    InitializeRecordedEvents(&editor->Recording);
+    editor->ReplayIndex = 0;
+    editor->StartTime = 0;
 
     InitializeRows(&editor->Rows);
+    InitializeEditorRowKinds(&editor->RowKinds);
+    InitializeLineIndex(&editor->LineIndex, MeasureRowBytes, editor);
+    InitializeLineIndex(&editor->WrapIndex, MeasureRowLines, editor);
+    InitializeDisplayCache(&editor->Display, options->TabWidth);
+    InitializeSyntaxCache(&editor->Syntax);
     editor->Filepath = EmptyString;
+    editor->Save = NULL;
+    editor->SaveEdits = 0;
+    editor->Journal = NULL;
+    editor->Watcher.Handle = -1;
+    editor->Watcher.Pending = false;
+    editor->Stream = NULL;
+    editor->Followed = EmptyString;
+
+    InitializeHistory(&editor->History, HISTORY_DEFAULT_CAPACITY);
+    InitializeHistoryOperations(&editor->HistoryOperations);
+
+    MemoryClear(&editor->Search, sizeof(EditorSearch));
+    InitializeRegexMatches(&editor->Search.RegexMatches);
+
+    InitializeEditorCursors(&editor->Cursors);
+    InitializeEditorCursors(&editor->CursorJoins);
+    InitializeEditorCursorPads(&editor->CursorPads);
 
     editor->Running = true;
     editor->Mode = EDITOR_MODE_VIEW;
@@ -61,24 +223,67 @@ void InitializeEditor(Editor* editor)
 
     editor->OffsetX = 0;
     editor->OffsetY = 0;
+    editor->ScrollX = 0;
+
+    editor->SoftWrap = false;
+    editor->OffsetSegment = 0;
 
     InitializeString(&editor->Status);
     editor->StatusTimeout = 0;
     editor->IsErrorStatus = false;
+
+    InitializeString(&editor->InputStatus);
+    InitializeString(&editor->PromptInfo);
 }
 
 void FinalizeEditor(Editor* editor)
 {
+    FinalizeString(&editor->PromptInfo);
+    FinalizeString(&editor->InputStatus);
     FinalizeString(&editor->Status);
 
+    FinalizeString(&editor->Search.Query);
+    FinalizeRegexMatches(&editor->Search.RegexMatches);
+    if (editor->Search.Regex != NULL)
+    {
+        DestroyRegexMatcher(editor->Search.Matcher);
+        DestroyRegex(editor->Search.Regex);
+    }
+
+    FinalizeEditorCursors(&editor->CursorJoins);
+    FinalizeEditorCursorPads(&editor->CursorPads);
+    FinalizeEditorCursors(&editor->Cursors);
+
+    if (editor->Save != NULL)
+        FinishSave(editor->Save);
+
+    if (editor->Journal != NULL)
+        DestroyJournal(editor->Journal, !editor->Running);
+
+    if (editor->Watcher.Handle >= 0)
+        CloseFileWatcher(&editor->Watcher);
+
+    FinalizeString(&editor->Followed);
     FinalizeString(&editor->Filepath);
     for (usize index = 0; index < editor->Rows.Count; index += 1)
         FinalizeString(&editor->Rows.Values[index]);
 
     FinalizeRows(&editor->Rows);
+    FinalizeEditorRowKinds(&editor->RowKinds);
+    FinalizeLineIndex(&editor->LineIndex);
+    FinalizeLineIndex(&editor->WrapIndex);
+    FinalizeDisplayCache(&editor->Display);
+    FinalizeSyntaxCache(&editor->Syntax);
+
+    FinalizeHistoryOperations(&editor->HistoryOperations);
+    FinalizeHistory(&editor->History);
+
+    FinalizeRecordedEvents(&editor->Recording);
 
     DestroyTerminal(editor->Terminal);
-    FinalizeCommandQueue(&editor->Commands);
+    FinalizeCommandStream(&editor->Commands);
+    if (editor->Workers != NULL)
+        DestroyThreadPool(editor->Workers);
 }
 
 void PrepareStatusMessage(Editor* editor, StringView message, bool isError)
@@ -90,41 +295,116 @@ void PrepareStatusMessage(Editor* editor, StringView message, bool isError)
 }
 
 void SaveFile(Editor* editor);
+void UpdateSaveStatus(Editor* editor);
+void ShowMemoryStatistics(Editor* editor);
 bool CreateRowsFromFile(Editor* editor);
-bool RunEditor(Editor* editor);
+usize RecoverJournalEdits(Editor* editor, JournalEdits* edits);
+EditorRowKind ClassifyRow(StringView row);
 void FixCursorPosition(Editor* editor);
+void ScrollToWrappedCursor(Editor* editor);
 void RefreshScreen(Editor* editor);
 void ProcessEvent(Editor* editor, Event* event);
-bool EditorPrompt(Editor* editor, String* prompt, StringView* out);
+bool ReadEditorEvent(Editor* editor, Event* event);
+bool HasPendingEditorEvents(Editor* editor);
+bool EditorPrompt(Editor* editor, String* prompt, StringView* out, EditorPromptCallback callback);
+bool ContinueSearch(Editor* editor);
+void ShowSearchSummary(Editor* editor);
+void ClearSearch(Editor* editor);
+void InvalidateSearch(Editor* editor);
+void FindNextMatch(Editor* editor);
+bool IsFollowPending(Editor* editor);
+void UpdateFollowedFile(Editor* editor);
+
+Editor* CreateEditor(Terminal* terminal, EditorOptions* options)
+{
+    Editor* editor = (Editor*)MemoryAllocate(sizeof(Editor));
+    InitializeEditor(editor, terminal, options);
+    return editor;
+}
+
+void DestroyEditor(Editor* editor)
+{
+    FinalizeEditor(editor);
+    MemoryFree(editor);
+}
+
+bool OpenEditorFile(Editor* editor, String filepath)
+{
+    FinalizeString(&editor->Filepath);
+    editor->Filepath = filepath;
+    editor->Syntax.Enabled = IsSyntaxPath(ToStringView(&editor->Filepath));
+    return CreateRowsFromFile(editor);
+}
+
+bool RunEditorWithNoFile(EditorOptions* options)
+{
+    Editor editor;
+    InitializeEditor(&editor, CreateTerminal(), options);
+    AddToRows(&editor.Rows, EmptyString);
+    AddToEditorRowKinds(&editor.RowKinds, EDITOR_ROW_PLAIN);
+    bool status = RunEditor(&editor);
+    FinalizeEditor(&editor);
+    return status;
+}
 
-bool RunEditorWithNoFile()
+bool RunEditorWithStream(EditorOptions* options)
 {
+    StreamSpill* spill = StartStreamSpill();
+    if (spill == NULL)
+    {
+        static const StringView streamError = AsStringView("Failed to read the standard input.\n");
+        WriteStdOut(streamError.Content, streamError.Length);
+        return false;
+    }
+
     Editor editor;
-    InitializeEditor(&editor);
+    InitializeEditor(&editor, CreateTerminal(), options);
     AddToRows(&editor.Rows, EmptyString);
+    AddToEditorRowKinds(&editor.RowKinds, EDITOR_ROW_PLAIN);
+    OpenSpillWatcher(spill, &editor.Watcher);
+    editor.Stream = spill;
     bool status = RunEditor(&editor);
     FinalizeEditor(&editor);
+
+    if (IsStreamSpillTruncated(spill))
+    {
+        static const StringView streamTruncated = AsStringView("The standard input exceeded the memory limit and was not read to the end.\n");
+        WriteStdOut(streamTruncated.Content, streamTruncated.Length);
+    }
+
+    if (!FinishStreamSpill(spill))
+    {
+        static const StringView streamError = AsStringView("Failed to read the standard input.\n");
+        WriteStdOut(streamError.Content, streamError.Length);
+    }
+
     return status;
 }
 
-bool RunEditorWithFile(String filepath)
+bool RunEditorWithFile(String filepath, EditorOptions* options)
 {
     Editor editor;
-    InitializeEditor(&editor);
-    editor.Filepath = filepath;
-    bool status = CreateRowsFromFile(&editor) && RunEditor(&editor);
+    InitializeEditor(&editor, CreateTerminal(), options);
+    bool status = OpenEditorFile(&editor, filepath) && RunEditor(&editor);
     FinalizeEditor(&editor);
     return status;
 }
 
 void SaveFile(Editor* editor)
 {
+    if (editor->Save != NULL)
+    {
+        static const StringView saveBusy = AsStringView("The file is still being saved.");
+        PrepareStatusMessage(editor, saveBusy, true);
+        return;
+    }
+
     if (editor->Filepath.Length == 0)
     {
         String prompt = EmptyString;
         AppendStringView(&prompt, AsStringView("Save as: "));
         StringView out = EmptyStringView;
-        if (!EditorPrompt(editor, &prompt, &out))
+        if (!EditorPrompt(editor, &prompt, &out, NULL))
         {
             FinalizeString(&prompt);
             return;
@@ -138,28 +418,56 @@ void SaveFile(Editor* editor)
             return;
         }
 
+        u64 size, modified;
+        if (editor->Stream != NULL && IsStreamSpillTruncated(editor->Stream) && GetFileInfo(out, &size, &modified))
+        {
+            static const StringView truncatedError = AsStringView("The input was truncated, save it to a new file.");
+            PrepareStatusMessage(editor, truncatedError, true);
+            FinalizeString(&prompt);
+            return;
+        }
+
         editor->Filepath.Length = 0;
         AppendStringView(&editor->Filepath, out);
+        editor->Syntax.Enabled = IsSyntaxPath(out);
         FinalizeString(&prompt);
     }
 
-    String content = EmptyString;
-    for (usize index = 0; index < editor->Rows.Count; index += 1)
+    if (editor->Journal == NULL && editor->Watcher.Handle < 0)
+        editor->Journal = CreateJournal(ToStringView(&editor->Filepath), false);
+
+    editor->SaveEdits = GetJournalEditCount(editor->Journal);
+    editor->Save = StartSave(ToStringView(&editor->Filepath), editor->Options->Durability, EmptyStringView, editor->Rows.Values, editor->Rows.Count);
+    if (editor->Save == NULL)
     {
-        String* current = &editor->Rows.Values[index];
-        if (current->Length > 0)
-        {
-            AppendString(&content, &editor->Rows.Values[index]);
-        }
+        static const StringView fileError = AsStringView("Failed to write the file.");
+        PrepareStatusMessage(editor, fileError, true);
+        return;
+    }
 
-        if (index < editor->Rows.Count - 1)
-        {
-            AppendChar(&content, '\n');
-        }
+    WaitForSave(editor->Save, SAVE_FOREGROUND_NANOSECONDS);
+    UpdateSaveStatus(editor);
+}
+
+void UpdateSaveStatus(Editor* editor)
+{
+    if (!IsSaveFinished(editor->Save))
+    {
+        String message = EmptyString;
+        AppendStr(&message, "Saving the file... ");
+        AppendUInt(&message, GetSaveProgress(editor->Save));
+        AppendChar(&message, '%');
+        PrepareStatusMessage(editor, ToStringView(&message), false);
+        FinalizeString(&message);
+        return;
     }
 
-    if (WriteFile(ToStringView(&editor->Filepath), ToStringView(&content)))
+    bool saved = FinishSave(editor->Save);
+    editor->Save = NULL;
+
+    if (saved)
     {
+        RebaseJournal(editor->Journal, editor->SaveEdits);
         static const StringView fileSaved = AsStringView("The content saved to the file.");
         PrepareStatusMessage(editor, fileSaved, false);
     }
@@ -168,8 +476,14 @@ void SaveFile(Editor* editor)
         static const StringView fileError = AsStringView("Failed to write the file.");
         PrepareStatusMessage(editor, fileError, true);
     }
+}
 
-    FinalizeString(&content);
+void ShowMemoryStatistics(Editor* editor)
+{
+    String message = EmptyString;
+    AppendMemoryStatistics(&message);
+    PrepareStatusMessage(editor, ToStringView(&message), false);
+    FinalizeString(&message);
 }
 
 bool CreateRowsFromFile(Editor* editor)
@@ -182,6 +496,14 @@ bool CreateRowsFromFile(Editor* editor)
         return false;
     }
 
+    usize loaded = content.Length;
+    String swap = EmptyString;
+    JournalEdits edits;
+    InitializeJournalEdits(&edits);
+
+    bool follow = editor->Options->Follow;
+    JournalStatus journal = follow ? JOURNAL_STATUS_NONE : ReadJournal(ToStringView(&editor->Filepath), &content, &swap, &edits);
+
     for (usize start = 0, end = 0; end <= content.Length; end += 1)
     {
         if (content.Content[end] == '\n' || end == content.Length)
@@ -197,17 +519,58 @@ bool CreateRowsFromFile(Editor* editor)
             }
 
             AddToRows(&editor->Rows, line);
+            AddToEditorRowKinds(&editor->RowKinds, (u8)ClassifyRow(view));
             start = end + 1;
         }
     }
 
+    usize valid = ValidateUtf8(ToStringView(&content));
+    if (valid < content.Length)
+    {
+        String message = EmptyString;
+        AppendStr(&message, "The file is not valid UTF-8 (first invalid byte at offset ");
+        AppendUInt(&message, valid);
+        AppendStr(&message, ").");
+        PrepareStatusMessage(editor, ToStringView(&message), true);
+        FinalizeString(&message);
+    }
+
+    usize recovered = (journal == JOURNAL_STATUS_RECOVERED) ? RecoverJournalEdits(editor, &edits) : 0;
+    if (follow)
+        OpenFileWatcher(&editor->Watcher, ToStringView(&editor->Filepath), loaded);
+    else
+        editor->Journal = CreateJournal(ToStringView(&editor->Filepath), journal == JOURNAL_STATUS_RECOVERED);
+    if (journal == JOURNAL_STATUS_RECOVERED)
+    {
+        String message = EmptyString;
+        AppendStr(&message, "Recovered ");
+        AppendUInt(&message, recovered);
+        if (recovered < edits.Count)
+        {
+            AppendStr(&message, " of ");
+            AppendUInt(&message, edits.Count);
+            CheckpointJournal(editor->Journal);
+        }
+
+        AppendStr(&message, (edits.Count == 1) ? " edit from the swap file." : " edits from the swap file.");
+        PrepareStatusMessage(editor, ToStringView(&message), recovered < edits.Count);
+        FinalizeString(&message);
+    }
+    else if (journal == JOURNAL_STATUS_STALE)
+    {
+        static const StringView staleSwap = AsStringView("Ignored a swap file that does not match the file.");
+        PrepareStatusMessage(editor, staleSwap, true);
+    }
+
+    FinalizeJournalEdits(&edits);
+    FinalizeString(&swap);
     FinalizeString(&content);
     return true;
 }
 
 bool RunEditor(Editor* editor)
 {
-    if (!IsTTY())
+    if (!IsTerminalInteractive(editor->Terminal))
     {
         static StringView notTTY = AsStringView("Standard input/output is not a TTY.\n");
         WriteStdOut(notTTY.Content, notTTY.Length);
@@ -221,326 +584,2622 @@ bool RunEditor(Editor* editor)
         return false;
     }
 
+    bool replaying = editor->Options->ReplayPath.Length > 0;
+    if (replaying && !LoadRecordedEvents(ToStringView(&editor->Options->ReplayPath), &editor->Recording))
+    {
+        static StringView replayError = AsStringView("Failed to read the recorded events.\n");
+        WriteStdOut(replayError.Content, replayError.Length);
+        return false;
+    }
+
     EnableRawMode(editor->Terminal);
     EnterAlternateScreen(editor->Terminal);
 
+    TerminalStatistics initialStatistics;
+    GetTerminalStatistics(editor->Terminal, &initialStatistics);
+    editor->StartTime = GetMonotonicTime();
+
     Event event;
     while (editor->Running)
     {
-        FixCursorPosition(editor);
-        RefreshScreen(editor);
-        if (ReadEvent(editor->Terminal, &event))
+        if (editor->Save != NULL)
+            UpdateSaveStatus(editor);
+
+        if (editor->Watcher.Handle >= 0 && editor->Save == NULL)
+            UpdateFollowedFile(editor);
+
+        UpdateJournal(editor->Journal, editor->Rows.Values, editor->Rows.Count);
+        RenderEditorFrame(editor);
+
+        if (editor->Search.Scanning)
         {
-            ProcessEvent(editor, &event);
-        }
-    }
+            if (!ContinueSearch(editor))
+                ShowSearchSummary(editor);
 
-    LeaveAlternateScreen(editor->Terminal);
-    DisableRawMode(editor->Terminal);
-    return true;
-}
+            if (!HasPendingEditorEvents(editor))
+                continue;
+        }
 
-void FixCursorPosition(Editor* editor)
-{
-    usize index = editor->CursorY - 1 + editor->OffsetY;
-    usize length = editor->Rows.Values[index].Length;
+        if (IsFollowPending(editor) && !HasPendingEditorEvents(editor))
+            continue;
 
-    editor->FixedCursorX = Min(editor->CursorX, (u16)(length + 1 - editor->OffsetX));
-    editor->FixedCursorY = editor->CursorY;
-}
+        usize handledEvents = 0;
+        while (handledEvents < EDITOR_EVENT_BATCH && ReadEditorEvent(editor, &event))
+        {
+            HandleEditorEvent(editor, &event);
+            handledEvents += 1;
 
-void PrintLines(Editor* editor)
-{
-    Command command;
+            if (!editor->Running || !HasPendingEditorEvents(editor))
+                break;
+        }
+    }
 
-    for (u16 height = 1; height < editor->Height; height += 1)
-    {
-        MakeMoveCursorCommand(&command, 1, height);
-        EnqueueCommandQueue(&editor->Commands, command);
+    u64 elapsedTime = GetMonotonicTime() - editor->StartTime;
 
-        usize rowIndex = height - 1 + editor->OffsetY;
+    LeaveAlternateScreen(editor->Terminal);
+    DisableRawMode(editor->Terminal);
 
-        if (rowIndex < editor->Rows.Count)
+    if (editor->Save != NULL)
+    {
+        bool saved = FinishSave(editor->Save);
+        editor->Save = NULL;
+        if (!saved)
         {
-            String* currentRow = &editor->Rows.Values[rowIndex];
-            usize startIndex = Min(editor->OffsetX, currentRow->Length);
-            usize endIndex = Min(startIndex + editor->Width, currentRow->Length);
-            StringView contentToWrite = MakeStringView(currentRow, startIndex, endIndex);
-            if (contentToWrite.Length > 0)
+            static StringView saveError = AsStringView("Failed to write the file.\n");
+            WriteStdOut(saveError.Content, saveError.Length);
+
+            if (editor->Journal != NULL)
             {
-                MakePrintCommand(&command, contentToWrite);
-                EnqueueCommandQueue(&editor->Commands, command);
+                DestroyJournal(editor->Journal, false);
+                editor->Journal = NULL;
             }
         }
-        else
-        {
-            static StringView emptyLine = AsStringView("~");
-            MakePrintCommand(&command, emptyLine);
-            EnqueueCommandQueue(&editor->Commands, command);
-        }
+    }
+
+    if (editor->Options->RecordPath.Length > 0 && !SaveRecordedEvents(ToStringView(&editor->Options->RecordPath), &editor->Recording))
+    {
+        static StringView recordError = AsStringView("Failed to write the recorded events.\n");
+        WriteStdOut(recordError.Content, recordError.Length);
+    }
 
-        MakeClearLineCommand(&command, CLEAR_LINE_TO_END);
-        EnqueueCommandQueue(&editor->Commands, command);
+    if (replaying)
+    {
+        TerminalStatistics statistics;
+        GetTerminalStatistics(editor->Terminal, &statistics);
+
+        String report = EmptyString;
+        AppendStr(&report, "Replayed ");
+        AppendUInt(&report, editor->ReplayIndex);
+        AppendStr(&report, " events in ");
+        AppendUInt(&report, elapsedTime / 1000);
+        AppendStr(&report, " us: ");
+        AppendUInt(&report, statistics.Frames - initialStatistics.Frames);
+        AppendStr(&report, " frames rendered (");
+        AppendUInt(&report, statistics.DroppedFrames - initialStatistics.DroppedFrames);
+        AppendStr(&report, " dropped), ");
+        AppendUInt(&report, statistics.BytesWritten - initialStatistics.BytesWritten);
+        AppendStr(&report, " bytes written\n");
+        WriteStdOut(report.Content, report.Length);
+        FinalizeString(&report);
     }
+
+    return true;
 }
 
-void PrintStatusMessage(Editor* editor)
+bool ReadReplayedEvent(Editor* editor, Event* event)
 {
-    Command command;
-
-    MakeMoveCursorCommand(&command, 1, editor->Height);
-    EnqueueCommandQueue(&editor->Commands, command);
+    if (editor->ReplayIndex >= editor->Recording.Count)
+    {
+        editor->Running = false;
+        return false;
+    }
 
-    MakeSetForegroundCommand(&command, COLOR_WHITE);
-    EnqueueCommandQueue(&editor->Commands, command);
+    RecordedEvent* recorded = &editor->Recording.Values[editor->ReplayIndex];
+    if (editor->Options->ReplaySpeed == REPLAY_SPEED_RECORDED)
+    {
+        u64 elapsedTime = GetMonotonicTime() - editor->StartTime;
+        if (elapsedTime < recorded->Time)
+        {
+            u64 remainingTime = recorded->Time - elapsedTime;
+            SleepFor(Min(remainingTime, (u64)REPLAY_IDLE_NANOSECONDS));
+            if (remainingTime > REPLAY_IDLE_NANOSECONDS)
+                return false;
+        }
+    }
 
-    MakeSetBackgroundCommand(&command, editor->IsErrorStatus ? COLOR_RED : COLOR_CYAN);
-    EnqueueCommandQueue(&editor->Commands, command);
+    *event = recorded->Event;
+    editor->ReplayIndex += 1;
+    return true;
+}
 
-    MakePrintCommand(&command, ToStringView(&editor->Status));
-    EnqueueCommandQueue(&editor->Commands, command);
+bool ReadEditorEvent(Editor* editor, Event* event)
+{
+    if (editor->Options->ReplayPath.Length > 0)
+        return ReadReplayedEvent(editor, event);
 
-    MakeClearLineCommand(&command, CLEAR_LINE_TO_END);
-    EnqueueCommandQueue(&editor->Commands, command);
+    if (!ReadEvent(editor->Terminal, event))
+        return false;
 
-    MakeSetForegroundCommand(&command, COLOR_RESET);
-    EnqueueCommandQueue(&editor->Commands, command);
+    if (editor->Options->RecordPath.Length > 0)
+    {
+        u64 timestamp = (event->Timestamp > editor->StartTime) ? event->Timestamp : GetMonotonicTime();
+        RecordedEvent recorded = {.Time = timestamp - editor->StartTime, .Event = *event};
+        AddToRecordedEvents(&editor->Recording, recorded);
+    }
 
-    MakeSetBackgroundCommand(&command, COLOR_RESET);
-    EnqueueCommandQueue(&editor->Commands, command);
+    return true;
 }
 
-void PrintEditorInfo(Editor* editor)
+bool HasPendingEditorEvents(Editor* editor)
 {
-    Command command;
-
-    MakeMoveCursorCommand(&command, 1, editor->Height);
-    EnqueueCommandQueue(&editor->Commands, command);
+    if (editor->Options->ReplayPath.Length > 0)
+        return false;
 
-    MakeSetForegroundCommand(&command, COLOR_BLACK);
-    EnqueueCommandQueue(&editor->Commands, command);
+    return GetPendingEventCount(editor->Terminal) > 0;
+}
 
-    MakeSetBackgroundCommand(&command, COLOR_WHITE);
-    EnqueueCommandQueue(&editor->Commands, command);
+void RenderEditorFrame(Editor* editor)
+{
+    ProfileScope frameScope = BeginProfileScope("Frame");
 
-    static StringView status = AsStringView(" LIE - Lightweight Integrated Editor");
-    MakePrintCommand(&command, status);
-    EnqueueCommandQueue(&editor->Commands, command);
+    ProfileScope fixScope = BeginProfileScope("FixCursorPosition");
+    FixCursorPosition(editor);
+    EndProfileScope(fixScope);
 
-    MakeClearLineCommand(&command, CLEAR_LINE_TO_END);
-    EnqueueCommandQueue(&editor->Commands, command);
+    RefreshScreen(editor);
+    EndProfileScope(frameScope);
+}
 
-    u16 positionX = editor->FixedCursorX + editor->OffsetX;
-    u16 positionY = editor->FixedCursorY + editor->OffsetY;
-    u16 targetX = editor->Width - (u16)(Log10(positionY) + Log10(positionX) + 10);
-    MakeMoveCursorCommand(&command, targetX, editor->Height);
-    EnqueueCommandQueue(&editor->Commands, command);
+void HandleEditorEvent(Editor* editor, Event* event)
+{
+    ProfileScope eventScope = BeginProfileScope("ProcessEvent");
+    FixCursorPosition(editor);
+    ProcessEvent(editor, event);
+    if (editor->SoftWrap)
+    {
+        FixCursorPosition(editor);
+        ScrollToWrappedCursor(editor);
+    }
+    EndProfileScope(eventScope);
+}
 
-    editor->Status.Length = 0;
-    switch (editor->Mode)
+void FixCursorPosition(Editor* editor)
+{
+    usize index = editor->CursorY - 1 + editor->OffsetY;
+    usize length = editor->Rows.Values[index].Length;
+    if (editor->OffsetX > length)
     {
-        case EDITOR_MODE_VIEW:
-            AppendStringView(&editor->Status, AsStringView("- VIEW - "));
-            break;
-        case EDITOR_MODE_EDIT:
-            AppendStringView(&editor->Status, AsStringView("- EDIT - "));
-            break;
+        editor->OffsetX = length - Min(length, (usize)(editor->Width - 1));
+        editor->CursorX = (u16)(length + 1 - editor->OffsetX);
     }
-    AppendUInt(&editor->Status, positionY);
-    AppendStringView(&editor->Status, AsStringView(":"));
-    AppendUInt(&editor->Status, positionX);
-    MakePrintCommand(&command, ToStringView(&editor->Status));
-    EnqueueCommandQueue(&editor->Commands, command);
 
-    MakeSetForegroundCommand(&command, COLOR_RESET);
-    EnqueueCommandQueue(&editor->Commands, command);
+    editor->FixedCursorX = (u16)Min((usize)editor->CursorX, length + 1 - editor->OffsetX);
+    editor->FixedCursorY = editor->CursorY;
+}
 
-    MakeSetBackgroundCommand(&command, COLOR_RESET);
-    EnqueueCommandQueue(&editor->Commands, command);
+usize GetCursorRow(Editor* editor)
+{
+    return editor->FixedCursorY - 1 + editor->OffsetY;
 }
 
-void RefreshScreen(Editor* editor)
+usize GetCursorColumn(Editor* editor)
 {
-    Command command;
+    return editor->FixedCursorX - 1 + editor->OffsetX;
+}
 
-    MakeHideCursorCommand(&command);
-    EnqueueCommandQueue(&editor->Commands, command);
+EditorRowKind ClassifyRow(StringView row)
+{
+    return (SkipPlainDisplayBytes(row, 0, row.Length) == row.Length) ? EDITOR_ROW_PLAIN : EDITOR_ROW_MIXED;
+}
 
-    PrintLines(editor);
+EditorRowKind SplitRowKind(u8 kind)
+{
+    return (kind == EDITOR_ROW_PLAIN) ? EDITOR_ROW_PLAIN : EDITOR_ROW_UNKNOWN;
+}
 
-    if (editor->StatusTimeout == 0)
-    {
-        PrintEditorInfo(editor);
-    }
-    else
-    {
-        PrintStatusMessage(editor);
-        editor->StatusTimeout -= 1;
-    }
+EditorRowKind JoinRowKinds(u8 first, u8 second)
+{
+    if (first == EDITOR_ROW_MIXED || second == EDITOR_ROW_MIXED)
+        return EDITOR_ROW_MIXED;
 
-    MakeMoveCursorCommand(&command, editor->FixedCursorX, editor->FixedCursorY);
-    EnqueueCommandQueue(&editor->Commands, command);
+    return (first == EDITOR_ROW_PLAIN && second == EDITOR_ROW_PLAIN) ? EDITOR_ROW_PLAIN : EDITOR_ROW_UNKNOWN;
+}
 
-    MakeShowCursorCommand(&command);
-    EnqueueCommandQueue(&editor->Commands, command);
+bool IsPlainRow(Editor* editor, usize row)
+{
+    u8* kind = &editor->RowKinds.Values[row];
+    if (*kind == EDITOR_ROW_UNKNOWN)
+        *kind = (u8)ClassifyRow(ToStringView(&editor->Rows.Values[row]));
 
-    ProcessCommandQueue(editor->Terminal, &editor->Commands);
-    ClearCommandQueue(&editor->Commands);
+    return *kind == EDITOR_ROW_PLAIN;
 }
 
-void MoveCursorToLineStart(Editor* editor)
+usize GetRowDisplayColumn(Editor* editor, usize row, usize column)
 {
-    editor->CursorX = 1;
-    editor->OffsetX = 0;
+    if (IsPlainRow(editor, row))
+        return Min(column, editor->Rows.Values[row].Length);
+
+    return GetDisplayColumn(&editor->Display, row, ToStringView(&editor->Rows.Values[row]), column);
 }
 
-void MoveCursorToLineEnd(Editor* editor)
+usize GetRowDisplayByte(Editor* editor, usize row, usize column)
 {
-    usize rowIndex = editor->CursorY - 1 + editor->OffsetY;
-    usize rowLength = editor->Rows.Values[rowIndex].Length;
+    if (IsPlainRow(editor, row))
+        return Min(column, editor->Rows.Values[row].Length);
 
-    editor->OffsetX = (u16)(rowLength - Min(rowLength, editor->Width - 1));
-    editor->CursorX = (u16)(rowLength + 1 - editor->OffsetX);
+    return GetDisplayByte(&editor->Display, row, ToStringView(&editor->Rows.Values[row]), column);
 }
 
-void MoveUp(Editor* editor, u16 count)
+usize GetRowDisplayWidth(Editor* editor, usize row)
 {
-    u16 move = Min(editor->CursorY - 1, count);
-    editor->CursorY -= move;
+    if (IsPlainRow(editor, row))
+        return editor->Rows.Values[row].Length;
 
-    u16 offset = Min(editor->OffsetY, count - move);
-    editor->OffsetY -= offset;
+    return GetDisplayWidth(&editor->Display, row, ToStringView(&editor->Rows.Values[row]));
 }
 
-void MoveDown(Editor* editor, u16 count)
+u64 MeasureRowBytes(void* context, usize row)
 {
-    u16 remaningRows = (u16)(editor->Rows.Count - editor->OffsetY);
+    Editor* editor = (Editor*)context;
+    return editor->Rows.Values[row].Length + 1;
+}
 
-    u16 move = Min(remaningRows - editor->CursorY, count);
-    move = Min(move, editor->Height - editor->CursorY - 1);
-    editor->CursorY += move;
+u64 MeasureRowLines(void* context, usize row)
+{
+    Editor* editor = (Editor*)context;
+    return GetRowDisplayWidth(editor, row) / editor->Width + 1;
+}
 
-    u16 offset = Min(remaningRows - Min(remaningRows, editor->Height), count - move);
-    editor->OffsetY += offset;
+LineIndex* GetLineIndex(Editor* editor)
+{
+    if (editor->LineIndex.Stale)
+        RebuildLineIndex(&editor->LineIndex, editor->Rows.Count);
+
+    return &editor->LineIndex;
 }
 
-void MoveLeft(Editor* editor, u16 count)
+LineIndex* GetWrapIndex(Editor* editor)
 {
-    usize rowIndex = editor->CursorY - 1 + editor->OffsetY;
+    if (editor->WrapIndex.Stale)
+        RebuildLineIndex(&editor->WrapIndex, editor->Rows.Count);
 
-    u16 move = Min(editor->FixedCursorX - 1, count);
-    editor->CursorX = editor->FixedCursorX - move;
+    return &editor->WrapIndex;
+}
 
-    u16 offset = Min(editor->OffsetX, count - move);
-    editor->OffsetX -= offset;
+StringView GetSpaces(usize count)
+{
+    static const StringView spaces = AsStringView("                ");
+    return (StringView){.Length = count, .Content = spaces.Content};
+}
+
+StringView GetTabSpaces(Editor* editor, usize row, usize column)
+{
+    usize tabWidth = editor->Display.TabWidth;
+    return GetSpaces(tabWidth - GetRowDisplayColumn(editor, row, column) % tabWidth);
+}
+
+void UpdateRowLayout(Editor* editor, usize row, usize column, StringView inserted)
+{
+    u8* kind = &editor->RowKinds.Values[row];
+    if (ClassifyRow(inserted) == EDITOR_ROW_MIXED)
+        *kind = EDITOR_ROW_MIXED;
+    else if (*kind == EDITOR_ROW_MIXED)
+        *kind = EDITOR_ROW_UNKNOWN;
+
+    InvalidateDisplayRow(&editor->Display, row, column);
+    UpdateLineIndex(&editor->LineIndex, row);
+    UpdateLineIndex(&editor->WrapIndex, row);
+}
+
+void SplitRowLayout(Editor* editor, usize row, usize column)
+{
+    InsertDisplayRow(&editor->Display, row + 1);
+    InvalidateDisplayRow(&editor->Display, row, column);
+    UpdateLineIndex(&editor->LineIndex, row);
+    UpdateLineIndex(&editor->WrapIndex, row);
+    InsertLineIndex(&editor->LineIndex, row + 1);
+    InsertLineIndex(&editor->WrapIndex, row + 1);
+}
+
+void JoinRowLayout(Editor* editor, usize row, usize column)
+{
+    RemoveDisplayRow(&editor->Display, row + 1);
+    InvalidateDisplayRow(&editor->Display, row, column);
+    RemoveLineIndex(&editor->LineIndex, row + 1);
+    RemoveLineIndex(&editor->WrapIndex, row + 1);
+    UpdateLineIndex(&editor->LineIndex, row);
+    UpdateLineIndex(&editor->WrapIndex, row);
+}
+
+void ResizeRowLayout(Editor* editor, usize rowCount)
+{
+    ResizeLineIndex(&editor->LineIndex, rowCount);
+    ResizeLineIndex(&editor->WrapIndex, rowCount);
+}
+
+void MoveRowLayout(Editor* editor, usize from, usize to)
+{
+    MoveLineIndex(&editor->LineIndex, from, to);
+    MoveLineIndex(&editor->WrapIndex, from, to);
+}
+
+void MeasureRowLayout(Editor* editor, usize row)
+{
+    UpdateLineIndex(&editor->LineIndex, row);
+    UpdateLineIndex(&editor->WrapIndex, row);
+}
+
+void InvalidateRowLayout(Editor* editor)
+{
+    ClearDisplayCache(&editor->Display);
+    editor->LineIndex.Stale = true;
+    editor->WrapIndex.Stale = true;
+}
+
+u64 GetVisualLine(Editor* editor, usize row, usize column)
+{
+    return GetLineOffset(GetWrapIndex(editor), row) + GetRowDisplayColumn(editor, row, column) / editor->Width;
+}
+
+u64 GetTopVisualLine(Editor* editor)
+{
+    LineIndex* wrapIndex = GetWrapIndex(editor);
+    u64 first = GetLineOffset(wrapIndex, editor->OffsetY);
+    u64 segments = GetLineOffset(wrapIndex, editor->OffsetY + 1) - first;
+    return first + Min((u64)editor->OffsetSegment, segments - 1);
+}
+
+void ScrollToVisualLine(Editor* editor, usize row, u64 line)
+{
+    LineIndex* wrapIndex = GetWrapIndex(editor);
+    u64 textHeight = (u64)(editor->Height - 1);
+    u64 top = GetTopVisualLine(editor);
+    if (line < top)
+        top = line;
+    else if (line >= top + textHeight)
+        top = line - textHeight + 1;
+
+    editor->OffsetY = FindLineAtOffset(wrapIndex, top);
+    editor->OffsetSegment = (usize)(top - GetLineOffset(wrapIndex, editor->OffsetY));
+    editor->CursorY = (u16)(row - editor->OffsetY + 1);
+    editor->FixedCursorY = editor->CursorY;
+}
+
+void ScrollToWrappedCursor(Editor* editor)
+{
+    usize row = GetCursorRow(editor);
+    ScrollToVisualLine(editor, row, GetVisualLine(editor, row, GetCursorColumn(editor)));
+}
+
+void ScrollToCursorColumn(Editor* editor)
+{
+    usize column = GetRowDisplayColumn(editor, GetCursorRow(editor), GetCursorColumn(editor));
+    if (column < editor->ScrollX)
+        editor->ScrollX = column;
+    else if (column >= editor->ScrollX + editor->Width)
+        editor->ScrollX = column - editor->Width + 1;
+}
+
+bool GetScreenPosition(Editor* editor, usize row, usize column, u16* x, u16* y)
+{
+    if (editor->SoftWrap)
+    {
+        u64 line = GetVisualLine(editor, row, column);
+        u64 top = GetTopVisualLine(editor);
+        if (line < top || line >= top + editor->Height - 1)
+            return false;
+
+        *x = (u16)(GetRowDisplayColumn(editor, row, column) % editor->Width + 1);
+        *y = (u16)(line - top + 1);
+        return true;
+    }
+
+    if (row < editor->OffsetY || row >= editor->OffsetY + editor->Height - 1)
+        return false;
+
+    usize displayColumn = GetRowDisplayColumn(editor, row, column);
+    if (displayColumn < editor->ScrollX || displayColumn >= editor->ScrollX + editor->Width)
+        return false;
+
+    *x = (u16)(displayColumn - editor->ScrollX + 1);
+    *y = (u16)(row - editor->OffsetY + 1);
+    return true;
+}
+
+isize FindInRow(String* row, usize start, StringView query)
+{
+    if (start > row->Length)
+        return -1;
+
+    isize found = FindSubstring(MakeStringView(row, start, row->Length), query);
+    return (found < 0) ? -1 : (isize)start + found;
+}
+
+void ReserveFrameCommands(Editor* editor, usize count)
+{
+    ReserveCommandStream(&editor->Commands, count + editor->Height + EDITOR_FRAME_COMMANDS);
+}
+
+usize GetSliceCommandLimit(EditorSlice* slice)
+{
+    // Every print covers at least one byte of the slice or pads a tab that does, and every colour change
+    // brackets a match or syntax run of at least one byte, so no row emits more than eight commands per byte.
+    return EDITOR_ROW_COMMANDS_PER_BYTE * (slice->End - slice->Start) + EDITOR_FRAME_COMMANDS;
+}
+
+bool FindHighlight(Editor* editor, String* row, usize from, usize* start, usize* end)
+{
+    EditorSearch* search = &editor->Search;
+    if (search->Matcher != NULL)
+    {
+        while (FindRegexInLine(search->Matcher, ToStringView(row), from, start, end))
+        {
+            if (*end > *start)
+                return true;
+
+            from = *start + 1;
+        }
+
+        return false;
+    }
+
+    if (search->Query.Length == 0)
+        return false;
+
+    isize found = FindInRow(row, from, ToStringView(&search->Query));
+    if (found < 0)
+        return false;
+
+    *start = (usize)found;
+    *end = *start + search->Query.Length;
+    return true;
+}
+
+EditorSlice MakeEditorSlice(Editor* editor, usize rowIndex, usize firstColumn)
+{
+    String* row = &editor->Rows.Values[rowIndex];
+    EditorSlice slice = {.Row = rowIndex, .FirstColumn = firstColumn, .LastColumn = firstColumn + editor->Width};
+
+    usize visible = Min(slice.LastColumn, row->Length);
+    if (IsPlainRow(editor, rowIndex)
+        || (slice.LastColumn <= DISPLAY_CHECKPOINT_INTERVAL && SkipPlainDisplayBytes(ToStringView(row), 0, visible) == visible))
+    {
+        slice.Start = Min(slice.FirstColumn, row->Length);
+        slice.End = visible;
+        slice.Plain = true;
+        slice.Byte = slice.Start;
+        slice.Column = slice.Start;
+        return slice;
+    }
+
+    slice.Start = GetRowDisplayByte(editor, rowIndex, slice.FirstColumn);
+    slice.End = GetRowDisplayByte(editor, rowIndex, slice.LastColumn);
+    bool plain = SkipPlainDisplayBytes(ToStringView(row), slice.End, Min(slice.End + 1, row->Length)) > slice.End;
+    if (slice.End < row->Length && !plain && GetRowDisplayColumn(editor, rowIndex, slice.End) < slice.LastColumn)
+    {
+        usize width;
+        slice.End += MeasureDisplayCharacter(&editor->Display, ToStringView(row), slice.End, 0, &width);
+    }
+
+    slice.Plain = SkipPlainDisplayBytes(ToStringView(row), slice.Start, slice.End) == slice.End;
+    slice.Byte = slice.Start;
+    slice.Column = GetRowDisplayColumn(editor, rowIndex, slice.Start);
+    return slice;
+}
+
+void PrintDisplayRun(Editor* editor, StringView text)
+{
+    if (text.Length == 0)
+        return;
+
+    MakePrintCommand(EmitCommand(&editor->Commands), text);
+}
+
+void PrintDisplayText(Editor* editor, EditorSlice* slice, usize end)
+{
+    static const StringView spaces = AsStringView("                ");
+
+    String* row = &editor->Rows.Values[slice->Row];
+    usize printed = slice->Byte;
+    while (slice->Byte < end)
+    {
+        usize plain = SkipPlainDisplayBytes(ToStringView(row), slice->Byte, end);
+        slice->Column += plain - slice->Byte;
+        slice->Byte = plain;
+        if (slice->Byte >= end)
+            break;
+
+        usize width;
+        usize size = MeasureDisplayCharacter(&editor->Display, ToStringView(row), slice->Byte, slice->Column, &width);
+
+        usize first = Max(slice->Column, slice->FirstColumn);
+        usize last = Min(slice->Column + width, slice->LastColumn);
+        if (row->Content[slice->Byte] == '\t' || first != slice->Column || last != slice->Column + width)
+        {
+            PrintDisplayRun(editor, MakeStringView(row, printed, slice->Byte));
+            if (last > first)
+                PrintDisplayRun(editor, (StringView){.Length = last - first, .Content = spaces.Content});
+
+            printed = slice->Byte + size;
+        }
+
+        slice->Byte += size;
+        slice->Column += width;
+    }
+
+    PrintDisplayRun(editor, MakeStringView(row, printed, slice->Byte));
+}
+
+void PrintHighlightedRow(Editor* editor, u16 y, EditorSlice* slice, usize start, usize end)
+{
+    String* row = &editor->Rows.Values[slice->Row];
+
+    MakeMoveCursorCommand(EmitCommand(&editor->Commands), 1, y);
+
+    while (start < slice->End)
+    {
+        usize matchStart = Max(start, slice->Byte);
+        usize matchEnd = Min(end, slice->End);
+        if (matchEnd > matchStart)
+        {
+            PrintDisplayText(editor, slice, matchStart);
+
+            MakeSetForegroundCommand(EmitCommand(&editor->Commands), COLOR_BLACK);
+            MakeSetBackgroundCommand(EmitCommand(&editor->Commands), COLOR_YELLOW);
+
+            PrintDisplayText(editor, slice, matchEnd);
+
+            MakeSetForegroundCommand(EmitCommand(&editor->Commands), COLOR_RESET);
+            MakeSetBackgroundCommand(EmitCommand(&editor->Commands), COLOR_RESET);
+        }
+
+        if (!FindHighlight(editor, row, end, &start, &end))
+            break;
+    }
+
+    PrintDisplayText(editor, slice, slice->End);
+    MakeClearLineCommand(EmitCommand(&editor->Commands), CLEAR_LINE_TO_END);
+}
+
+void PrintSyntaxRow(Editor* editor, u16 y, EditorSlice* slice, SyntaxStyle* style)
+{
+    SyntaxRuns* runs = &editor->Syntax.Runs;
+
+    usize low = 0, high = runs->Count;
+    while (low < high)
+    {
+        usize middle = low + (high - low) / 2;
+        if (runs->Values[middle].End <= slice->Start)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    MakeMoveCursorCommand(EmitCommand(&editor->Commands), 1, y);
+    for (usize index = low; index < runs->Count; index += 1)
+    {
+        SyntaxRun* run = &runs->Values[index];
+        if (run->Start >= slice->End)
+            break;
+
+        usize end = Min(run->End, slice->End);
+        if (slice->Byte >= end)
+            continue;
+
+        if (run->Style != *style)
+        {
+            MakeSetForegroundCommand(EmitCommand(&editor->Commands), GetSyntaxColor(run->Style));
+            *style = run->Style;
+        }
+
+        PrintDisplayText(editor, slice, end);
+    }
+
+    PrintDisplayText(editor, slice, slice->End);
+    MakeClearLineCommand(EmitCommand(&editor->Commands), CLEAR_LINE_TO_END);
+}
+
+void ResetSyntaxStyle(Editor* editor, SyntaxStyle* style)
+{
+    if (*style == SYNTAX_STYLE_NORMAL)
+        return;
+
+    MakeSetForegroundCommand(EmitCommand(&editor->Commands), COLOR_RESET);
+    *style = SYNTAX_STYLE_NORMAL;
+}
+
+void PrintRow(Editor* editor, u16 y, EditorSlice* slice, usize from, usize* lexedRow, SyntaxStyle* style)
+{
+    String* row = &editor->Rows.Values[slice->Row];
+    ReserveFrameCommands(editor, GetSliceCommandLimit(slice));
+
+    usize start, end;
+    if (FindHighlight(editor, row, from, &start, &end) && start < slice->End)
+    {
+        ResetSyntaxStyle(editor, style);
+        PrintHighlightedRow(editor, y, slice, start, end);
+    }
+    else if (editor->Syntax.Enabled)
+    {
+        if (*lexedRow != slice->Row)
+            LexSyntaxLine(ToStringView(row), GetSyntaxStartState(&editor->Syntax, slice->Row), &editor->Syntax.Runs);
+
+        *lexedRow = slice->Row;
+        PrintSyntaxRow(editor, y, slice, style);
+    }
+    else if (slice->Plain)
+    {
+        MakePrintRowCommand(EmitCommand(&editor->Commands), y, MakeStringView(row, slice->Start, slice->End));
+    }
+    else
+    {
+        MakeMoveCursorCommand(EmitCommand(&editor->Commands), 1, y);
+        PrintDisplayText(editor, slice, slice->End);
+        MakeClearLineCommand(EmitCommand(&editor->Commands), CLEAR_LINE_TO_END);
+    }
+}
+
+void PrintWrappedLines(Editor* editor)
+{
+    LineIndex* wrapIndex = GetWrapIndex(editor);
+    usize rowIndex = editor->OffsetY;
+    usize segment = (usize)(GetTopVisualLine(editor) - GetLineOffset(wrapIndex, rowIndex));
+    usize lexedRow = editor->Rows.Count;
+
+    SyntaxStyle style = SYNTAX_STYLE_NORMAL;
+    for (u16 height = 1; height < editor->Height; height += 1)
+    {
+        if (rowIndex < editor->Rows.Count)
+        {
+            EditorSlice slice = MakeEditorSlice(editor, rowIndex, segment * editor->Width);
+            usize from = slice.Start - Min(slice.Start, editor->Search.Query.Length);
+            PrintRow(editor, height, &slice, from, &lexedRow, &style);
+
+            segment += 1;
+            if (segment >= GetLineOffset(wrapIndex, rowIndex + 1) - GetLineOffset(wrapIndex, rowIndex))
+            {
+                rowIndex += 1;
+                segment = 0;
+            }
+        }
+        else
+        {
+            static StringView emptyLine = AsStringView("~");
+            ResetSyntaxStyle(editor, &style);
+            MakePrintRowCommand(EmitCommand(&editor->Commands), height, emptyLine);
+        }
+    }
+
+    ResetSyntaxStyle(editor, &style);
+}
+
+void PrintLines(Editor* editor)
+{
+    if (editor->Syntax.Enabled)
+        PrepareSyntax(&editor->Syntax, editor->Rows.Values, editor->Rows.Count, editor->OffsetY + editor->Height - 1);
+
+    if (editor->SoftWrap)
+    {
+        PrintWrappedLines(editor);
+        return;
+    }
+
+    usize lexedRow = editor->Rows.Count;
+    SyntaxStyle style = SYNTAX_STYLE_NORMAL;
+    for (u16 height = 1; height < editor->Height; height += 1)
+    {
+        usize rowIndex = height - 1 + editor->OffsetY;
+
+        if (rowIndex < editor->Rows.Count)
+        {
+            EditorSlice slice = MakeEditorSlice(editor, rowIndex, editor->ScrollX);
+            PrintRow(editor, height, &slice, 0, &lexedRow, &style);
+        }
+        else
+        {
+            static StringView emptyLine = AsStringView("~");
+            ResetSyntaxStyle(editor, &style);
+            MakePrintRowCommand(EmitCommand(&editor->Commands), height, emptyLine);
+        }
+    }
+
+    ResetSyntaxStyle(editor, &style);
+}
+
+bool IsCursorBefore(EditorCursor* cursor, usize row, usize column)
+{
+    return cursor->Row < row || (cursor->Row == row && cursor->Column < column);
+}
+
+usize FindCursorIndex(EditorCursors* cursors, usize row, usize column)
+{
+    usize low = 0, high = cursors->Count;
+    while (low < high)
+    {
+        usize middle = low + (high - low) / 2;
+        if (IsCursorBefore(&cursors->Values[middle], row, column))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+void PrintCursors(Editor* editor)
+{
+    static const StringView blank = AsStringView(" ");
+
+    EditorCursors* cursors = &editor->Cursors;
+    usize endRow = editor->OffsetY + editor->Height - 1;
+    usize first = FindCursorIndex(cursors, editor->OffsetY, 0);
+    usize last = FindCursorIndex(cursors, endRow, 0);
+    ReserveFrameCommands(editor, (last - first) * 6);
+
+    for (usize index = first; index < last; index += 1)
+    {
+        EditorCursor* cursor = &cursors->Values[index];
+
+        u16 x, y;
+        if (!GetScreenPosition(editor, cursor->Row, cursor->Column, &x, &y))
+            continue;
+
+        String* row = &editor->Rows.Values[cursor->Row];
+
+        StringView character = blank;
+        if (cursor->Column < row->Length && row->Content[cursor->Column] != '\t')
+        {
+            usize width;
+            usize size = MeasureDisplayCharacter(&editor->Display, ToStringView(row), cursor->Column, 0, &width);
+            if (x + width <= (usize)editor->Width + 1)
+                character = MakeStringView(row, cursor->Column, cursor->Column + size);
+        }
+
+        Command* commands = EmitCommands(&editor->Commands, 6);
+        MakeMoveCursorCommand(&commands[0], x, y);
+        MakeSetForegroundCommand(&commands[1], COLOR_BLACK);
+        MakeSetBackgroundCommand(&commands[2], COLOR_WHITE);
+        MakePrintCommand(&commands[3], character);
+        MakeSetForegroundCommand(&commands[4], COLOR_RESET);
+        MakeSetBackgroundCommand(&commands[5], COLOR_RESET);
+    }
+}
+
+void PrintStatusMessage(Editor* editor)
+{
+    Command* commands = EmitCommands(&editor->Commands, 7);
+    MakeMoveCursorCommand(&commands[0], 1, editor->Height);
+    MakeSetForegroundCommand(&commands[1], COLOR_WHITE);
+    MakeSetBackgroundCommand(&commands[2], editor->IsErrorStatus ? COLOR_RED : COLOR_CYAN);
+    MakePrintCommand(&commands[3], ToStringView(&editor->Status));
+    MakeClearLineCommand(&commands[4], CLEAR_LINE_TO_END);
+    MakeSetForegroundCommand(&commands[5], COLOR_RESET);
+    MakeSetBackgroundCommand(&commands[6], COLOR_RESET);
+}
+
+void PrintEditorInfo(Editor* editor)
+{
+    Command* commands = EmitCommands(&editor->Commands, 3);
+    MakeMoveCursorCommand(&commands[0], 1, editor->Height);
+    MakeSetForegroundCommand(&commands[1], COLOR_BLACK);
+    MakeSetBackgroundCommand(&commands[2], COLOR_WHITE);
+
+    static StringView status = AsStringView(" LIE - Lightweight Integrated Editor");
+    MakePrintCommand(EmitCommand(&editor->Commands), status);
+
+    TerminalStatistics statistics;
+    GetTerminalStatistics(editor->Terminal, &statistics);
+    usize pendingEvents = GetPendingEventCount(editor->Terminal);
+
+    editor->InputStatus.Length = 0;
+    if (statistics.FrameInterval > 0)
+    {
+        AppendStr(&editor->InputStatus, " (");
+        AppendUInt(&editor->InputStatus, 1000000000 / statistics.FrameInterval);
+        AppendStr(&editor->InputStatus, " fps)");
+    }
+
+    if (pendingEvents > 0)
+    {
+        AppendStr(&editor->InputStatus, " (");
+        AppendUInt(&editor->InputStatus, pendingEvents);
+        AppendStr(&editor->InputStatus, " queued)");
+    }
+
+    if (editor->Cursors.Count > 0)
+    {
+        AppendStr(&editor->InputStatus, " (");
+        AppendUInt(&editor->InputStatus, editor->Cursors.Count + 1);
+        AppendStr(&editor->InputStatus, " cursors)");
+    }
+
+    if (editor->Stream != NULL && IsStreamSpillTruncated(editor->Stream))
+        AppendStr(&editor->InputStatus, " (input truncated)");
+
+    if (editor->InputStatus.Length > 0)
+        MakePrintCommand(EmitCommand(&editor->Commands), ToStringView(&editor->InputStatus));
+
+    MakeClearLineCommand(EmitCommand(&editor->Commands), CLEAR_LINE_TO_END);
+
+    usize positionX = editor->FixedCursorX + editor->OffsetX;
+    usize positionY = editor->FixedCursorY + editor->OffsetY;
+
+    LineIndex* lineIndex = GetLineIndex(editor);
+    u64 offset = GetLineOffset(lineIndex, positionY - 1) + positionX - 1;
+    u64 size = GetLineIndexSize(lineIndex);
+
+    editor->Status.Length = 0;
+    switch (editor->Mode)
+    {
+        case EDITOR_MODE_VIEW:
+            AppendStringView(&editor->Status, AsStringView("- VIEW - "));
+            break;
+        case EDITOR_MODE_EDIT:
+            AppendStringView(&editor->Status, AsStringView("- EDIT - "));
+            break;
+    }
+    AppendUInt(&editor->Status, positionY);
+    AppendStringView(&editor->Status, AsStringView(":"));
+    AppendUInt(&editor->Status, positionX);
+    AppendStringView(&editor->Status, AsStringView(" @"));
+    AppendUInt(&editor->Status, offset);
+    AppendStringView(&editor->Status, AsStringView(" "));
+    AppendUInt(&editor->Status, (size > 0) ? Min(offset, size) * 100 / size : 100);
+    AppendStringView(&editor->Status, AsStringView("%"));
+
+    u16 targetX = (u16)(editor->Width - Min(editor->Status.Length, (usize)(editor->Width - 1)));
+    MakeMoveCursorCommand(EmitCommand(&editor->Commands), targetX, editor->Height);
+
+    commands = EmitCommands(&editor->Commands, 3);
+    MakePrintCommand(&commands[0], ToStringView(&editor->Status));
+    MakeSetForegroundCommand(&commands[1], COLOR_RESET);
+    MakeSetBackgroundCommand(&commands[2], COLOR_RESET);
+}
+
+void RefreshScreen(Editor* editor)
+{
+    ProfileScope refreshScope = BeginProfileScope("RefreshScreen");
+
+    if (editor->SoftWrap)
+        ScrollToWrappedCursor(editor);
+    else
+        ScrollToCursorColumn(editor);
+
+    ReserveFrameCommands(editor, 0);
+    MakeHideCursorCommand(EmitCommand(&editor->Commands));
+
+    ProfileScope linesScope = BeginProfileScope("PrintLines");
+    PrintLines(editor);
+    PrintCursors(editor);
+    EndProfileScope(linesScope);
+
+    if (editor->StatusTimeout == 0)
+    {
+        ProfileScope infoScope = BeginProfileScope("PrintEditorInfo");
+        PrintEditorInfo(editor);
+        EndProfileScope(infoScope);
+    }
+    else
+    {
+        ProfileScope statusScope = BeginProfileScope("PrintStatusMessage");
+        PrintStatusMessage(editor);
+        EndProfileScope(statusScope);
+        editor->StatusTimeout -= 1;
+    }
+
+    u16 x = editor->FixedCursorX, y = editor->FixedCursorY;
+    GetScreenPosition(editor, GetCursorRow(editor), GetCursorColumn(editor), &x, &y);
+
+    ReserveFrameCommands(editor, 2);
+    Command* commands = EmitCommands(&editor->Commands, 2);
+    MakeMoveCursorCommand(&commands[0], x, y);
+    MakeShowCursorCommand(&commands[1]);
+
+    ProcessCommandStream(editor->Terminal, &editor->Commands);
+    ClearCommandStream(&editor->Commands);
+
+    EndProfileScope(refreshScope);
+}
+
+void MoveCursorToLineStart(Editor* editor)
+{
+    editor->CursorX = 1;
+    editor->OffsetX = 0;
+}
+
+void MoveCursorToLineEnd(Editor* editor)
+{
+    usize rowIndex = editor->CursorY - 1 + editor->OffsetY;
+    usize rowLength = editor->Rows.Values[rowIndex].Length;
+
+    editor->OffsetX = rowLength - Min(rowLength, (usize)(editor->Width - 1));
+    editor->CursorX = (u16)(rowLength + 1 - editor->OffsetX);
+}
+
+void MoveUp(Editor* editor, u16 count)
+{
+    u16 move = Min(editor->CursorY - 1, count);
+    editor->CursorY -= move;
+
+    usize offset = Min(editor->OffsetY, (usize)(count - move));
+    editor->OffsetY -= offset;
+}
+
+void MoveDown(Editor* editor, u16 count)
+{
+    if (editor->SoftWrap)
+    {
+        usize row = Min(editor->CursorY - 1 + editor->OffsetY + count, editor->Rows.Count - 1);
+        editor->CursorY = (u16)(row - editor->OffsetY + 1);
+        return;
+    }
+
+    usize remaningRows = editor->Rows.Count - editor->OffsetY;
+
+    u16 move = (u16)Min(remaningRows - editor->CursorY, (usize)count);
+    move = Min(move, editor->Height - editor->CursorY - 1);
+    editor->CursorY += move;
+
+    usize offset = Min(remaningRows - Min(remaningRows, (usize)editor->Height), (usize)(count - move));
+    editor->OffsetY += offset;
+}
+
+usize GetGoalColumn(Editor* editor)
+{
+    usize row = editor->CursorY - 1 + editor->OffsetY;
+    usize column = editor->CursorX - 1 + editor->OffsetX;
+    usize length = editor->Rows.Values[row].Length;
+    if (column > length)
+        return GetRowDisplayColumn(editor, row, length) + column - length;
+
+    return GetRowDisplayColumn(editor, row, column);
+}
+
+void SetGoalColumn(Editor* editor, usize goal, usize minimum)
+{
+    usize row = editor->CursorY - 1 + editor->OffsetY;
+    String* current = &editor->Rows.Values[row];
+
+    usize column = GetRowDisplayByte(editor, row, goal);
+    if (column == current->Length)
+    {
+        column += goal - Min(goal, GetRowDisplayColumn(editor, row, column));
+    }
+    else if (GetRowDisplayColumn(editor, row, column) < minimum)
+    {
+        usize width;
+        column += MeasureDisplayCharacter(&editor->Display, ToStringView(current), column, 0, &width);
+    }
+
+    usize reachable = Min(column, current->Length);
+    editor->OffsetX = reachable - Min(reachable, (usize)(editor->Width - 1));
+    editor->CursorX = (u16)Min(column - editor->OffsetX + 1, (usize)0xFFFF);
+}
+
+void MoveToVisualLine(Editor* editor, u64 line, usize goal)
+{
+    LineIndex* wrapIndex = GetWrapIndex(editor);
+    usize row = FindLineAtOffset(wrapIndex, line);
+    usize segment = (usize)(line - GetLineOffset(wrapIndex, row));
+    ScrollToVisualLine(editor, row, line);
+    SetGoalColumn(editor, segment * editor->Width + goal % editor->Width, segment * editor->Width);
+}
+
+void MoveVisualUp(Editor* editor, u16 count)
+{
+    usize goal = GetGoalColumn(editor);
+    if (!editor->SoftWrap)
+    {
+        MoveUp(editor, count);
+        SetGoalColumn(editor, goal, 0);
+        return;
+    }
+
+    u64 line = GetVisualLine(editor, GetCursorRow(editor), GetCursorColumn(editor));
+    MoveToVisualLine(editor, line - Min(line, (u64)count), goal);
+}
+
+void MoveVisualDown(Editor* editor, u16 count)
+{
+    usize goal = GetGoalColumn(editor);
+    if (!editor->SoftWrap)
+    {
+        MoveDown(editor, count);
+        SetGoalColumn(editor, goal, 0);
+        return;
+    }
+
+    LineIndex* wrapIndex = GetWrapIndex(editor);
+    u64 line = GetVisualLine(editor, GetCursorRow(editor), GetCursorColumn(editor));
+    u64 last = GetLineOffset(wrapIndex, wrapIndex->Count) - 1;
+    MoveToVisualLine(editor, Min(line + count, last), goal);
+}
+
+u16 GetCharacterSizeBeforeCursor(Editor* editor)
+{
+    usize column = GetCursorColumn(editor);
+    if (column == 0)
+        return 1;
+
+    StringView row = ToStringView(&editor->Rows.Values[GetCursorRow(editor)]);
+    return (u16)(column - FindPreviousCodepoint(row, column));
+}
+
+u16 GetCharacterSizeAtCursor(Editor* editor)
+{
+    usize column = GetCursorColumn(editor);
+    StringView row = ToStringView(&editor->Rows.Values[GetCursorRow(editor)]);
+    if (column >= row.Length)
+        return 1;
+
+    return (u16)(FindNextCodepoint(row, column) - column);
+}
+
+void MoveLeft(Editor* editor, u16 count)
+{
+    usize rowIndex = editor->CursorY - 1 + editor->OffsetY;
+
+    u16 move = Min(editor->FixedCursorX - 1, count);
+    editor->CursorX = editor->FixedCursorX - move;
+
+    u16 offset = (u16)Min(editor->OffsetX, (usize)(count - move));
+    editor->OffsetX -= offset;
 
     u16 excess = count - move - offset;
     if (excess > 0 && rowIndex > 0)
     {
-        MoveUp(editor, 1);
-        MoveCursorToLineEnd(editor);
-        if (excess > 1)
+        MoveUp(editor, 1);
+        MoveCursorToLineEnd(editor);
+        if (excess > 1)
+        {
+            MoveLeft(editor, excess - 1);
+        }
+    }
+}
+
+void MoveRight(Editor* editor, u16 count)
+{
+    usize rowIndex = editor->CursorY - 1 + editor->OffsetY;
+    usize rowLength = editor->Rows.Values[rowIndex].Length;
+
+    usize remaining = rowLength + 1 - editor->OffsetX;
+
+    u16 move = (u16)Min(remaining - editor->FixedCursorX, (usize)count);
+    move = Min(move, editor->Width - editor->FixedCursorX);
+    editor->CursorX = editor->FixedCursorX + move;
+
+    u16 offset = (u16)Min(remaining - editor->CursorX, (usize)(count - move));
+    editor->OffsetX += offset;
+
+    u16 excess = count - move - offset;
+    if (excess > 0 && rowIndex < editor->Rows.Count - 1)
+    {
+        MoveDown(editor, 1);
+        MoveCursorToLineStart(editor);
+        if (excess > 1)
+        {
+            MoveRight(editor, excess - 1);
+        }
+    }
+}
+
+void SetCursorPosition(Editor* editor, usize row, usize column)
+{
+    usize textHeight = (usize)(editor->Height - 1);
+    if (row < editor->OffsetY || row >= editor->OffsetY + textHeight)
+    {
+        editor->OffsetY = row - Min(row, textHeight / 2);
+        editor->OffsetSegment = 0;
+    }
+
+    if (column < editor->OffsetX || column >= editor->OffsetX + editor->Width)
+        editor->OffsetX = column - Min(column, (usize)(editor->Width - 1));
+
+    editor->CursorY = (u16)(row - editor->OffsetY + 1);
+    editor->CursorX = (u16)(column - editor->OffsetX + 1);
+    editor->FixedCursorX = editor->CursorX;
+    editor->FixedCursorY = editor->CursorY;
+}
+
+void PreserveEditorRow(Editor* editor, String* row)
+{
+    PreserveSavedRow(editor->Save, row);
+    PreserveJournalRow(editor->Journal, row);
+}
+
+void ApplyInsert(Editor* editor, usize row, usize column, StringView bytes)
+{
+    InvalidateSearch(editor);
+    InvalidateSyntaxRow(&editor->Syntax, row);
+    PreserveEditorRow(editor, &editor->Rows.Values[row]);
+    JournalEdit edit = {.Kind = HISTORY_OPERATION_INSERT, .Row = row, .Column = column, .Removed = 0, .Inserted = bytes};
+    AppendJournalEdit(editor->Journal, &edit);
+    InsertStringView(&editor->Rows.Values[row], column, bytes);
+    UpdateRowLayout(editor, row, column, bytes);
+}
+
+void ApplyDelete(Editor* editor, usize row, usize column, usize length)
+{
+    InvalidateSearch(editor);
+    InvalidateSyntaxRow(&editor->Syntax, row);
+    PreserveEditorRow(editor, &editor->Rows.Values[row]);
+    JournalEdit edit = {.Kind = HISTORY_OPERATION_DELETE, .Row = row, .Column = column, .Removed = length, .Inserted = EmptyStringView};
+    AppendJournalEdit(editor->Journal, &edit);
+    EraseString(&editor->Rows.Values[row], column, column + length);
+    UpdateRowLayout(editor, row, column, EmptyStringView);
+}
+
+void ApplySplit(Editor* editor, usize row, usize column)
+{
+    JournalEdit edit = {.Kind = HISTORY_OPERATION_SPLIT, .Row = row, .Column = column, .Removed = 0, .Inserted = EmptyStringView};
+    AppendJournalEdit(editor->Journal, &edit);
+    InvalidateSearch(editor);
+    InsertSyntaxRow(&editor->Syntax, row + 1);
+    InsertToRows(&editor->Rows, EmptyString, row + 1);
+
+    EditorRowKind kind = SplitRowKind(editor->RowKinds.Values[row]);
+    editor->RowKinds.Values[row] = (u8)kind;
+    InsertToEditorRowKinds(&editor->RowKinds, (u8)kind, row + 1);
+
+    String* currentRow = &editor->Rows.Values[row];
+    StringView contentToEnd = MakeStringView(currentRow, column, currentRow->Length);
+    if (contentToEnd.Length > 0)
+    {
+        AppendStringView(&editor->Rows.Values[row + 1], contentToEnd);
+        PreserveEditorRow(editor, currentRow);
+        EraseString(currentRow, column, currentRow->Length);
+    }
+
+    SplitRowLayout(editor, row, column);
+}
+
+void ApplyJoin(Editor* editor, usize row)
+{
+    JournalEdit edit = {.Kind = HISTORY_OPERATION_JOIN, .Row = row, .Column = 0, .Removed = 0, .Inserted = EmptyStringView};
+    AppendJournalEdit(editor->Journal, &edit);
+    InvalidateSearch(editor);
+    RemoveSyntaxRow(&editor->Syntax, row + 1);
+    String* nextRow = &editor->Rows.Values[row + 1];
+    usize column = editor->Rows.Values[row].Length;
+    PreserveEditorRow(editor, &editor->Rows.Values[row]);
+    PreserveEditorRow(editor, nextRow);
+    if (nextRow->Length > 0)
+        AppendString(&editor->Rows.Values[row], nextRow);
+
+    FinalizeString(nextRow);
+    RemoveFromRows(&editor->Rows, row + 1);
+
+    EditorRowKinds* kinds = &editor->RowKinds;
+    kinds->Values[row] = (u8)JoinRowKinds(kinds->Values[row], kinds->Values[row + 1]);
+    RemoveFromEditorRowKinds(kinds, row + 1);
+    JoinRowLayout(editor, row, column);
+}
+
+void ApplyReplace(Editor* editor, usize row, usize column, usize length, StringView bytes)
+{
+    InvalidateSearch(editor);
+    InvalidateSyntaxRow(&editor->Syntax, row);
+    String* target = &editor->Rows.Values[row];
+    PreserveEditorRow(editor, target);
+    JournalEdit edit = {.Kind = HISTORY_OPERATION_REPLACE, .Row = row, .Column = column, .Removed = length, .Inserted = bytes};
+    AppendJournalEdit(editor->Journal, &edit);
+    EraseString(target, column, column + length);
+    if (bytes.Length > 0)
+        InsertStringView(target, column, bytes);
+
+    UpdateRowLayout(editor, row, column, bytes);
+}
+
+usize RecoverJournalEdits(Editor* editor, JournalEdits* edits)
+{
+    BeginHistoryBatch(&editor->History);
+
+    usize recovered = 0;
+    for (; recovered < edits->Count; recovered += 1)
+    {
+        JournalEdit* edit = &edits->Values[recovered];
+        if (edit->Row >= editor->Rows.Count)
+            break;
+
+        String* row = &editor->Rows.Values[edit->Row];
+        if (edit->Column > row->Length || edit->Removed > row->Length - edit->Column)
+            break;
+
+        if (edit->Kind == HISTORY_OPERATION_JOIN && edit->Row + 1 >= editor->Rows.Count)
+            break;
+
+        HistoryOperation operation = {
+            .Kind = edit->Kind,
+            .Row = edit->Row,
+            .Column = edit->Column,
+            .Bytes = edit->Inserted,
+            .Replacement = EmptyStringView,
+        };
+
+        if (edit->Kind == HISTORY_OPERATION_DELETE || edit->Kind == HISTORY_OPERATION_REPLACE)
+        {
+            operation.Bytes = MakeStringView(row, edit->Column, edit->Column + edit->Removed);
+            operation.Replacement = edit->Inserted;
+        }
+        else if (edit->Kind == HISTORY_OPERATION_JOIN)
+        {
+            operation.Column = row->Length;
+        }
+
+        RecordHistoryBatch(&editor->History, &operation);
+
+        switch (edit->Kind)
+        {
+            case HISTORY_OPERATION_INSERT:
+                ApplyInsert(editor, edit->Row, edit->Column, edit->Inserted);
+                break;
+            case HISTORY_OPERATION_DELETE:
+                ApplyDelete(editor, edit->Row, edit->Column, edit->Removed);
+                break;
+            case HISTORY_OPERATION_SPLIT:
+                ApplySplit(editor, edit->Row, edit->Column);
+                break;
+            case HISTORY_OPERATION_JOIN:
+                ApplyJoin(editor, edit->Row);
+                break;
+            case HISTORY_OPERATION_REPLACE:
+                ApplyReplace(editor, edit->Row, edit->Column, edit->Removed, edit->Inserted);
+                break;
+        }
+    }
+
+    EndHistoryBatch(&editor->History);
+    return recovered;
+}
+
+void AppendFollowedBytes(Editor* editor, StringView bytes)
+{
+    usize tail = editor->Rows.Count - 1;
+    for (usize start = 0, end = 0; end <= bytes.Length; end += 1)
+    {
+        if (end < bytes.Length && bytes.Content[end] != '\n')
+            continue;
+
+        StringView view = {.Length = end - start, .Content = bytes.Content + start};
+        if (start == 0)
+        {
+            String* row = &editor->Rows.Values[tail];
+            usize column = row->Length;
+            if (view.Length > 0)
+                AppendStringView(row, view);
+
+            if (end < bytes.Length && row->Length > 0 && row->Content[row->Length - 1] == '\r')
+            {
+                row->Length -= 1;
+                row->Content[row->Length] = '\0';
+            }
+
+            InvalidateSyntaxRow(&editor->Syntax, tail);
+            UpdateRowLayout(editor, tail, Min(column, row->Length), view);
+        }
+        else
+        {
+            if (end < bytes.Length && view.Length > 0 && view.Content[view.Length - 1] == '\r')
+                view.Length -= 1;
+
+            String line = EmptyString;
+            if (view.Length > 0)
+                AppendStringView(&line, view);
+
+            AddToRows(&editor->Rows, line);
+            AddToEditorRowKinds(&editor->RowKinds, (u8)ClassifyRow(view));
+        }
+
+        start = end + 1;
+    }
+
+    AppendLineIndex(&editor->LineIndex, editor->Rows.Count);
+    AppendLineIndex(&editor->WrapIndex, editor->Rows.Count);
+    InvalidateSearch(editor);
+}
+
+void ResetFollowedRows(Editor* editor)
+{
+    for (usize index = 0; index < editor->Rows.Count; index += 1)
+        FinalizeString(&editor->Rows.Values[index]);
+
+    ClearRows(&editor->Rows);
+    ClearEditorRowKinds(&editor->RowKinds);
+    AddToRows(&editor->Rows, EmptyString);
+    AddToEditorRowKinds(&editor->RowKinds, EDITOR_ROW_PLAIN);
+
+    InvalidateRowLayout(editor);
+    InvalidateSyntaxFrom(&editor->Syntax, 0);
+    FinalizeHistory(&editor->History);
+    InitializeHistory(&editor->History, HISTORY_DEFAULT_CAPACITY);
+    ClearEditorCursors(&editor->Cursors);
+    ClearSearch(editor);
+    SetCursorPosition(editor, 0, 0);
+
+    static const StringView truncated = AsStringView("The file was truncated and is read again.");
+    PrepareStatusMessage(editor, truncated, false);
+}
+
+usize GetFollowedEndRow(Editor* editor)
+{
+    usize row = editor->Rows.Count - 1;
+    return (row > 0 && editor->Rows.Values[row].Length == 0) ? row - 1 : row;
+}
+
+bool IsStreamOverLimit(Editor* editor)
+{
+    if (editor->Stream == NULL)
+        return false;
+
+    MemoryStatistics statistics;
+    GetMemoryStatistics(&statistics);
+    return statistics.LiveBytes >= STREAM_MEMORY_LIMIT;
+}
+
+void StopFollowedStream(Editor* editor, bool finished)
+{
+    bool truncated = editor->Watcher.Pending || !finished;
+    CloseFileWatcher(&editor->Watcher);
+    if (!truncated)
+        return;
+
+    StopStreamSpill(editor->Stream);
+
+    String message = EmptyString;
+    AppendStr(&message, "The input stopped at the ");
+    AppendByteSize(&message, STREAM_MEMORY_LIMIT);
+    AppendStr(&message, " memory limit; the rest is not loaded.");
+    PrepareStatusMessage(editor, ToStringView(&message), true);
+    FinalizeString(&message);
+}
+
+bool IsFollowPending(Editor* editor)
+{
+    return editor->Watcher.Handle >= 0 && editor->Save == NULL && editor->Watcher.Pending;
+}
+
+void UpdateFollowedFile(Editor* editor)
+{
+    u64 start = GetMonotonicTime();
+    usize cursorRow = GetCursorRow(editor);
+    bool atEnd = cursorRow >= GetFollowedEndRow(editor) && (editor->Options->Follow || cursorRow > 0);
+    bool changed = false;
+    do
+    {
+        bool finished = editor->Stream != NULL && IsStreamSpillFinished(editor->Stream);
+        FileChange change = ReadFileChanges(&editor->Watcher, &editor->Followed);
+        if (change == FILE_CHANGE_NONE)
+            break;
+
+        if (change == FILE_CHANGE_TRUNCATED)
+            ResetFollowedRows(editor);
+        else
+            AppendFollowedBytes(editor, ToStringView(&editor->Followed));
+
+        changed = true;
+        if (IsStreamOverLimit(editor))
+        {
+            StopFollowedStream(editor, finished);
+            break;
+        }
+    } while (editor->Watcher.Pending && GetMonotonicTime() - start < FOLLOW_SLICE_NANOSECONDS);
+
+    if (changed && atEnd && editor->Cursors.Count == 0)
+    {
+        usize row = GetFollowedEndRow(editor);
+        usize textHeight = (usize)(editor->Height - 1);
+        if (editor->Rows.Count > editor->OffsetY + textHeight)
+        {
+            editor->OffsetY = editor->Rows.Count - textHeight;
+            editor->OffsetSegment = 0;
+        }
+
+        SetCursorPosition(editor, row, 0);
+    }
+}
+
+void RecordEdit(Editor* editor, HistoryOperationKind kind, usize row, usize column, StringView bytes)
+{
+    HistoryOperation operation = {.Kind = kind, .Row = row, .Column = column, .Bytes = bytes};
+    RecordHistory(&editor->History, &operation);
+}
+
+usize BeginCursorEdit(Editor* editor)
+{
+    usize row = GetCursorRow(editor);
+    usize column = GetCursorColumn(editor);
+
+    EditorCursors* cursors = &editor->Cursors;
+    usize primaryIndex = FindCursorIndex(cursors, row, column);
+    EditorCursor* existing = (primaryIndex < cursors->Count) ? &cursors->Values[primaryIndex] : NULL;
+    if (existing == NULL || existing->Row != row || existing->Column != column)
+        InsertToEditorCursors(cursors, (EditorCursor){.Row = row, .Column = column}, primaryIndex);
+
+    BeginHistoryBatch(&editor->History);
+    return primaryIndex;
+}
+
+void MergeCursors(EditorCursors* cursors)
+{
+    for (usize index = 1; index < cursors->Count; index += 1)
+    {
+        EditorCursor cursor = cursors->Values[index];
+        usize target = index;
+        while (target > 0 && IsCursorBefore(&cursor, cursors->Values[target - 1].Row, cursors->Values[target - 1].Column))
+        {
+            cursors->Values[target] = cursors->Values[target - 1];
+            target -= 1;
+        }
+
+        cursors->Values[target] = cursor;
+    }
+
+    usize count = 0;
+    for (usize index = 0; index < cursors->Count; index += 1)
+    {
+        EditorCursor* cursor = &cursors->Values[index];
+        if (count > 0 && cursors->Values[count - 1].Row == cursor->Row && cursors->Values[count - 1].Column == cursor->Column)
+            continue;
+
+        cursors->Values[count] = *cursor;
+        count += 1;
+    }
+
+    cursors->Count = count;
+}
+
+void EndCursorEdit(Editor* editor, usize primaryIndex)
+{
+    EndHistoryBatch(&editor->History);
+    InvalidateSearch(editor);
+
+    EditorCursors* cursors = &editor->Cursors;
+    EditorCursor primary = cursors->Values[primaryIndex];
+    MergeCursors(cursors);
+    RemoveFromEditorCursors(cursors, FindCursorIndex(cursors, primary.Row, primary.Column));
+
+    SetCursorPosition(editor, primary.Row, primary.Column);
+}
+
+void InsertAtCursors(Editor* editor, StringView bytes, bool tab)
+{
+    usize primaryIndex = BeginCursorEdit(editor);
+    EditorCursors* cursors = &editor->Cursors;
+    EditorCursorPads* pads = &editor->CursorPads;
+    ClearEditorCursorPads(pads);
+
+    for (usize first = 0, end = 0; first < cursors->Count; first = end)
+    {
+        usize row = cursors->Values[first].Row;
+        usize changed = cursors->Values[first].Column;
+        String* target = &editor->Rows.Values[row];
+
+        usize length = target->Length;
+        for (end = first; end < cursors->Count && cursors->Values[end].Row == row; end += 1)
+        {
+            EditorCursor* cursor = &cursors->Values[end];
+            StringView inserted = bytes;
+            if (tab)
+            {
+                usize tabWidth = editor->Display.TabWidth;
+                usize column = GetRowDisplayColumn(editor, row, cursor->Column) + length - target->Length;
+                inserted = GetSpaces(tabWidth - column % tabWidth);
+                AddToEditorCursorPads(pads, (u8)inserted.Length);
+            }
+
+            HistoryOperation operation = {
+                .Kind = HISTORY_OPERATION_INSERT,
+                .Row = row,
+                .Column = cursor->Column + length - target->Length,
+                .Bytes = inserted,
+            };
+
+            RecordHistoryBatch(&editor->History, &operation);
+            AppendJournalOperation(editor->Journal, &operation);
+            length += inserted.Length;
+        }
+
+        PreserveEditorRow(editor, target);
+        ExtendString(target, length);
+        InvalidateSyntaxRow(&editor->Syntax, row);
+
+        usize tail = target->Length;
+        usize shift = length - target->Length;
+        for (usize index = end; index > first; index -= 1)
+        {
+            EditorCursor* cursor = &cursors->Values[index - 1];
+            StringView inserted = tab ? GetSpaces(pads->Values[index - 1]) : bytes;
+
+            MemoryCopy(target->Content + cursor->Column + shift, target->Content + cursor->Column, tail - cursor->Column);
+            shift -= inserted.Length;
+            MemoryCopy(target->Content + cursor->Column + shift, inserted.Content, inserted.Length);
+
+            tail = cursor->Column;
+            cursor->Column += shift + inserted.Length;
+        }
+
+        target->Length = length;
+        target->Content[length] = '\0';
+        UpdateRowLayout(editor, row, changed, bytes);
+    }
+
+    EndCursorEdit(editor, primaryIndex);
+}
+
+void JoinAtCursors(Editor* editor)
+{
+    Rows* rows = &editor->Rows;
+    EditorRowKinds* kinds = &editor->RowKinds;
+    EditorCursors* joins = &editor->CursorJoins;
+    ClearDisplayCache(&editor->Display);
+    InvalidateSyntaxFrom(&editor->Syntax, joins->Values[0].Row - 1);
+
+    usize write = joins->Values[0].Row;
+    usize join = 0;
+    for (usize read = write; read < rows->Count; read += 1)
+    {
+        if (join == joins->Count || joins->Values[join].Row != read)
+        {
+            rows->Values[write] = rows->Values[read];
+            kinds->Values[write] = kinds->Values[read];
+            MoveRowLayout(editor, read, write);
+            write += 1;
+            continue;
+        }
+
+        String* target = &rows->Values[write - 1];
+        if (join == 0 || joins->Values[join - 1].Row != read - 1)
+        {
+            usize length = target->Length;
+            for (usize next = join; next < joins->Count && joins->Values[next].Row == read + next - join; next += 1)
+                length += rows->Values[joins->Values[next].Row].Length;
+
+            PreserveEditorRow(editor, target);
+            ExtendString(target, length);
+        }
+
+        joins->Values[join].Column = target->Length;
+        HistoryOperation operation = {.Kind = HISTORY_OPERATION_JOIN, .Row = write - 1, .Column = target->Length, .Bytes = EmptyStringView};
+        RecordHistoryBatch(&editor->History, &operation);
+        AppendJournalOperation(editor->Journal, &operation);
+
+        String* source = &rows->Values[read];
+        if (source->Length > 0)
+            AppendString(target, source);
+
+        kinds->Values[write - 1] = (u8)JoinRowKinds(kinds->Values[write - 1], kinds->Values[read]);
+        MeasureRowLayout(editor, write - 1);
+
+        PreserveEditorRow(editor, source);
+        FinalizeString(source);
+        join += 1;
+    }
+
+    rows->Count = write;
+    kinds->Count = write;
+    ResizeRowLayout(editor, write);
+
+    EditorCursors* cursors = &editor->Cursors;
+    join = 0;
+    for (usize index = 0; index < cursors->Count; index += 1)
+    {
+        EditorCursor* cursor = &cursors->Values[index];
+        while (join < joins->Count && joins->Values[join].Row <= cursor->Row)
+            join += 1;
+
+        if (join > 0 && joins->Values[join - 1].Row == cursor->Row)
+            cursor->Column += joins->Values[join - 1].Column;
+
+        cursor->Row -= join;
+    }
+}
+
+usize GetDeletedCharacterSize(String* row, usize column, usize bound)
+{
+    return column - bound - FindPreviousCodepoint(MakeStringView(row, bound, column), column - bound);
+}
+
+void DeleteAtCursors(Editor* editor)
+{
+    usize primaryIndex = BeginCursorEdit(editor);
+    EditorCursors* cursors = &editor->Cursors;
+    EditorCursors* joins = &editor->CursorJoins;
+    ClearEditorCursors(joins);
+
+    for (usize first = 0, end = 0; first < cursors->Count; first = end)
+    {
+        usize row = cursors->Values[first].Row;
+        String* target = &editor->Rows.Values[row];
+
+        usize removed = 0;
+        usize previous = 0;
+        for (end = first; end < cursors->Count && cursors->Values[end].Row == row; end += 1)
+        {
+            EditorCursor* cursor = &cursors->Values[end];
+            if (cursor->Column == 0)
+            {
+                if (row > 0)
+                    AddToEditorCursors(joins, (EditorCursor){.Row = row, .Column = 0});
+
+                continue;
+            }
+
+            usize size = GetDeletedCharacterSize(target, cursor->Column, previous);
+            HistoryOperation operation = {
+                .Kind = HISTORY_OPERATION_DELETE,
+                .Row = row,
+                .Column = cursor->Column - size - removed,
+                .Bytes = MakeStringView(target, cursor->Column - size, cursor->Column),
+            };
+
+            RecordHistoryBatch(&editor->History, &operation);
+            AppendJournalOperation(editor->Journal, &operation);
+            removed += size;
+            previous = cursor->Column;
+        }
+
+        usize start = (cursors->Values[first].Column == 0) ? first + 1 : first;
+        usize size = (start < end) ? GetDeletedCharacterSize(target, cursors->Values[start].Column, 0) : 0;
+
+        PreserveEditorRow(editor, target);
+        removed = 0;
+        for (usize index = start; index < end; index += 1)
+        {
+            EditorCursor* cursor = &cursors->Values[index];
+            usize column = cursor->Column;
+
+            usize next = target->Length;
+            usize nextSize = 0;
+            if (index + 1 < end)
+            {
+                nextSize = GetDeletedCharacterSize(target, cursors->Values[index + 1].Column, column);
+                next = cursors->Values[index + 1].Column - nextSize;
+            }
+
+            MemoryCopy(target->Content + column - size - removed, target->Content + column, next - column);
+            removed += size;
+            cursor->Column = column - removed;
+            size = nextSize;
+        }
+
+        if (removed > 0)
+        {
+            InvalidateSyntaxRow(&editor->Syntax, row);
+            target->Length -= removed;
+            target->Content[target->Length] = '\0';
+            UpdateRowLayout(editor, row, cursors->Values[first].Column, EmptyStringView);
+        }
+    }
+
+    if (joins->Count > 0)
+        JoinAtCursors(editor);
+
+    EndCursorEdit(editor, primaryIndex);
+}
+
+void SplitAtCursors(Editor* editor)
+{
+    usize primaryIndex = BeginCursorEdit(editor);
+    EditorCursors* cursors = &editor->Cursors;
+    Rows* rows = &editor->Rows;
+    EditorRowKinds* kinds = &editor->RowKinds;
+    ClearDisplayCache(&editor->Display);
+    InvalidateSyntaxFrom(&editor->Syntax, cursors->Values[0].Row);
+
+    usize previous = 0;
+    for (usize index = 0; index < cursors->Count; index += 1)
+    {
+        EditorCursor* cursor = &cursors->Values[index];
+        if (index == 0 || cursors->Values[index - 1].Row != cursor->Row)
+            previous = 0;
+
+        HistoryOperation operation = {
+            .Kind = HISTORY_OPERATION_SPLIT,
+            .Row = cursor->Row + index,
+            .Column = cursor->Column - previous,
+            .Bytes = EmptyStringView,
+        };
+
+        RecordHistoryBatch(&editor->History, &operation);
+        AppendJournalOperation(editor->Journal, &operation);
+        previous = cursor->Column;
+    }
+
+    usize read = rows->Count;
+    for (usize index = 0; index < cursors->Count; index += 1)
+    {
+        AddToRows(rows, EmptyString);
+        AddToEditorRowKinds(kinds, EDITOR_ROW_UNKNOWN);
+    }
+
+    ResizeRowLayout(editor, rows->Count);
+    usize write = rows->Count;
+    usize remaining = cursors->Count;
+    while (remaining > 0)
+    {
+        read -= 1;
+        String row = rows->Values[read];
+        EditorRowKind kind = SplitRowKind(kinds->Values[read]);
+
+        usize length = row.Length;
+        usize tail = length;
+        while (remaining > 0 && cursors->Values[remaining - 1].Row == read)
+        {
+            EditorCursor* cursor = &cursors->Values[remaining - 1];
+            String piece = EmptyString;
+            if (tail > cursor->Column)
+                AppendStringView(&piece, MakeStringView(&row, cursor->Column, tail));
+
+            write -= 1;
+            rows->Values[write] = piece;
+            kinds->Values[write] = (u8)kind;
+            MeasureRowLayout(editor, write);
+
+            tail = cursor->Column;
+            cursor->Row = read + remaining;
+            cursor->Column = 0;
+            remaining -= 1;
+        }
+
+        if (tail < row.Length)
+        {
+            PreserveEditorRow(editor, &row);
+            row.Length = tail;
+            row.Content[tail] = '\0';
+        }
+
+        write -= 1;
+        rows->Values[write] = row;
+        kinds->Values[write] = (u8)kind;
+        if (tail < length)
+            MeasureRowLayout(editor, write);
+        else
+            MoveRowLayout(editor, read, write);
+    }
+
+    EndCursorEdit(editor, primaryIndex);
+}
+
+void MoveExtraCursors(Editor* editor, KeyCode code, usize count)
+{
+    EditorCursors* cursors = &editor->Cursors;
+    if (cursors->Count == 0)
+        return;
+
+    for (usize index = 0; index < cursors->Count; index += 1)
+    {
+        EditorCursor* cursor = &cursors->Values[index];
+        StringView row = ToStringView(&editor->Rows.Values[cursor->Row]);
+        usize goal = GetRowDisplayColumn(editor, cursor->Row, cursor->Column);
+        switch (code)
+        {
+            case KEY_CODE_UP:
+            case KEY_CODE_PAGE_UP:
+                cursor->Row -= Min(cursor->Row, count);
+                cursor->Column = GetRowDisplayByte(editor, cursor->Row, goal);
+                break;
+            case KEY_CODE_DOWN:
+            case KEY_CODE_PAGE_DOWN:
+                cursor->Row = Min(cursor->Row + count, editor->Rows.Count - 1);
+                cursor->Column = GetRowDisplayByte(editor, cursor->Row, goal);
+                break;
+            case KEY_CODE_LEFT:
+                if (cursor->Column > 0)
+                {
+                    cursor->Column = FindPreviousCodepoint(row, cursor->Column);
+                }
+                else if (cursor->Row > 0)
+                {
+                    cursor->Row -= 1;
+                    cursor->Column = editor->Rows.Values[cursor->Row].Length;
+                }
+                break;
+            case KEY_CODE_RIGHT:
+                if (cursor->Column < row.Length)
+                {
+                    cursor->Column = FindNextCodepoint(row, cursor->Column);
+                }
+                else if (cursor->Row + 1 < editor->Rows.Count)
+                {
+                    cursor->Row += 1;
+                    cursor->Column = 0;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    MergeCursors(cursors);
+}
+
+void AddCursorBelow(Editor* editor)
+{
+    EditorCursors* cursors = &editor->Cursors;
+    usize row = GetCursorRow(editor);
+    usize column = GetCursorColumn(editor);
+    if (cursors->Count > 0)
+        row = Max(row, cursors->Values[cursors->Count - 1].Row);
+
+    if (row + 1 >= editor->Rows.Count)
+        return;
+
+    EditorCursor cursor = {.Row = row + 1, .Column = Min(column, editor->Rows.Values[row + 1].Length)};
+    AddToEditorCursors(cursors, cursor);
+}
+
+void InsertBytes(Editor* editor, StringView bytes)
+{
+    if (editor->Cursors.Count > 0)
+    {
+        InsertAtCursors(editor, bytes, false);
+        return;
+    }
+
+    usize rowIndex = editor->FixedCursorY - 1 + editor->OffsetY;
+    usize insertIndex = editor->FixedCursorX + editor->OffsetX - 1;
+    RecordEdit(editor, HISTORY_OPERATION_INSERT, rowIndex, insertIndex, bytes);
+    ApplyInsert(editor, rowIndex, insertIndex, bytes);
+    MoveRight(editor, (u16)bytes.Length);
+}
+
+void InsertCharacter(Editor* editor, u32 codepoint)
+{
+    char bytes[4];
+    usize length = EncodeUtf8(codepoint, bytes);
+    InsertBytes(editor, (StringView){.Length = length, .Content = bytes});
+}
+
+void InsertTab(Editor* editor)
+{
+    if (editor->Cursors.Count > 0)
+    {
+        InsertAtCursors(editor, EmptyStringView, true);
+        return;
+    }
+
+    InsertBytes(editor, GetTabSpaces(editor, GetCursorRow(editor), GetCursorColumn(editor)));
+}
+
+void InsertNewLine(Editor* editor)
+{
+    if (editor->Cursors.Count > 0)
+    {
+        SplitAtCursors(editor);
+        return;
+    }
+
+    usize rowIndex = editor->FixedCursorY - 1 + editor->OffsetY;
+    usize insertIndex = editor->FixedCursorX - 1 + editor->OffsetX;
+    RecordEdit(editor, HISTORY_OPERATION_SPLIT, rowIndex, insertIndex, EmptyStringView);
+    ApplySplit(editor, rowIndex, insertIndex);
+
+    MoveCursorToLineStart(editor);
+    MoveDown(editor, 1);
+}
+
+void DeleteCharacter(Editor* editor)
+{
+    if (editor->Cursors.Count > 0)
+    {
+        DeleteAtCursors(editor);
+        return;
+    }
+
+    usize rowIndex = editor->FixedCursorY - 1 + editor->OffsetY;
+    String* currentRow = &editor->Rows.Values[rowIndex];
+
+    usize deleteIndex = editor->FixedCursorX - 1 + editor->OffsetX;
+    if (deleteIndex > 0)
+    {
+        usize start = FindPreviousCodepoint(ToStringView(currentRow), deleteIndex);
+        MoveLeft(editor, (u16)(deleteIndex - start));
+        RecordEdit(editor, HISTORY_OPERATION_DELETE, rowIndex, start, MakeStringView(currentRow, start, deleteIndex));
+        ApplyDelete(editor, rowIndex, start, deleteIndex - start);
+    }
+    else if (rowIndex > 0)
+    {
+        MoveUp(editor, 1);
+        MoveCursorToLineEnd(editor);
+
+        RecordEdit(editor, HISTORY_OPERATION_JOIN, rowIndex - 1, editor->Rows.Values[rowIndex - 1].Length, EmptyStringView);
+        ApplyJoin(editor, rowIndex - 1);
+    }
+}
+
+void UndoEdit(Editor* editor)
+{
+    ClearEditorCursors(&editor->Cursors);
+    if (!UndoHistory(&editor->History, &editor->HistoryOperations))
+    {
+        static const StringView nothingToUndo = AsStringView("Nothing to undo.");
+        PrepareStatusMessage(editor, nothingToUndo, false);
+        return;
+    }
+
+    for (usize index = 0; index < editor->HistoryOperations.Count; index += 1)
+    {
+        HistoryOperation* operation = &editor->HistoryOperations.Values[index];
+        switch (operation->Kind)
         {
-            MoveLeft(editor, excess - 1);
+            case HISTORY_OPERATION_INSERT:
+                ApplyDelete(editor, operation->Row, operation->Column, operation->Bytes.Length);
+                SetCursorPosition(editor, operation->Row, operation->Column);
+                break;
+            case HISTORY_OPERATION_DELETE:
+                ApplyInsert(editor, operation->Row, operation->Column, operation->Bytes);
+                SetCursorPosition(editor, operation->Row, operation->Column + operation->Bytes.Length);
+                break;
+            case HISTORY_OPERATION_SPLIT:
+                ApplyJoin(editor, operation->Row);
+                SetCursorPosition(editor, operation->Row, operation->Column);
+                break;
+            case HISTORY_OPERATION_JOIN:
+                ApplySplit(editor, operation->Row, operation->Column);
+                SetCursorPosition(editor, operation->Row + 1, 0);
+                break;
+            case HISTORY_OPERATION_REPLACE:
+                ApplyReplace(editor, operation->Row, operation->Column, operation->Replacement.Length, operation->Bytes);
+                SetCursorPosition(editor, operation->Row, operation->Column);
+                break;
         }
     }
 }
 
-void MoveRight(Editor* editor, u16 count)
+void RedoEdit(Editor* editor)
 {
-    usize rowIndex = editor->CursorY - 1 + editor->OffsetY;
-    usize rowLength = editor->Rows.Values[rowIndex].Length;
+    ClearEditorCursors(&editor->Cursors);
+    if (!RedoHistory(&editor->History, &editor->HistoryOperations))
+    {
+        static const StringView nothingToRedo = AsStringView("Nothing to redo.");
+        PrepareStatusMessage(editor, nothingToRedo, false);
+        return;
+    }
 
-    u16 remaining = (u16)(rowLength + 1 - editor->OffsetX);
+    for (usize index = 0; index < editor->HistoryOperations.Count; index += 1)
+    {
+        HistoryOperation* operation = &editor->HistoryOperations.Values[index];
+        switch (operation->Kind)
+        {
+            case HISTORY_OPERATION_INSERT:
+                ApplyInsert(editor, operation->Row, operation->Column, operation->Bytes);
+                SetCursorPosition(editor, operation->Row, operation->Column + operation->Bytes.Length);
+                break;
+            case HISTORY_OPERATION_DELETE:
+                ApplyDelete(editor, operation->Row, operation->Column, operation->Bytes.Length);
+                SetCursorPosition(editor, operation->Row, operation->Column);
+                break;
+            case HISTORY_OPERATION_SPLIT:
+                ApplySplit(editor, operation->Row, operation->Column);
+                SetCursorPosition(editor, operation->Row + 1, 0);
+                break;
+            case HISTORY_OPERATION_JOIN:
+                ApplyJoin(editor, operation->Row);
+                SetCursorPosition(editor, operation->Row, operation->Column);
+                break;
+            case HISTORY_OPERATION_REPLACE:
+                ApplyReplace(editor, operation->Row, operation->Column, operation->Bytes.Length, operation->Replacement);
+                SetCursorPosition(editor, operation->Row, operation->Column);
+                break;
+        }
+    }
+}
 
-    u16 move = Min(remaining - editor->FixedCursorX, count);
-    move = Min(move, editor->Width - editor->FixedCursorX);
-    editor->CursorX = editor->FixedCursorX + move;
+void StartSearch(Editor* editor)
+{
+    EditorSearch* search = &editor->Search;
+    search->Scanning = search->Query.Length > 0;
+    search->ScanRow = search->OriginRow;
+    search->ScannedRows = 0;
+    search->Matches = 0;
+    search->Found = false;
+    search->Wrapped = false;
+
+    SetCursorPosition(editor, search->OriginRow, search->OriginColumn);
+}
 
-    u16 offset = Min(remaining - editor->CursorX, count - move);
-    editor->OffsetX += offset;
+bool ContinueSearch(Editor* editor)
+{
+    EditorSearch* search = &editor->Search;
+    if (!search->Scanning)
+        return false;
 
-    u16 excess = count - move - offset;
-    if (excess > 0 && rowIndex < editor->Rows.Count - 1)
+    StringView query = ToStringView(&search->Query);
+    u64 deadline = GetMonotonicTime() + SEARCH_SLICE_NANOSECONDS;
+    while (search->ScannedRows < editor->Rows.Count)
     {
-        MoveDown(editor, 1);
-        MoveCursorToLineStart(editor);
-        if (excess > 1)
+        usize rowIndex = search->ScanRow % editor->Rows.Count;
+        String* row = &editor->Rows.Values[rowIndex];
+
+        usize count = CountSubstrings(ToStringView(row), query);
+        if (count > 0)
         {
-            MoveRight(editor, excess - 1);
+            search->Matches += count;
+
+            isize found = FindInRow(row, (rowIndex == search->OriginRow) ? search->OriginColumn : 0, query);
+            if (!search->Found && found >= 0 && rowIndex >= search->OriginRow)
+            {
+                search->Found = true;
+                if (search->Prompting)
+                    SetCursorPosition(editor, rowIndex, (usize)found);
+            }
+            else if (!search->Found && (!search->Wrapped || search->WrappedRow == search->OriginRow))
+            {
+                search->Wrapped = true;
+                search->WrappedRow = rowIndex;
+                search->WrappedColumn = (usize)FindInRow(row, 0, query);
+            }
         }
+
+        search->ScanRow = rowIndex + 1;
+        search->ScannedRows += 1;
+        if (search->ScannedRows % SEARCH_CLOCK_INTERVAL == 0 && GetMonotonicTime() >= deadline)
+            return true;
     }
+
+    if (!search->Found && search->Wrapped && search->Prompting)
+        SetCursorPosition(editor, search->WrappedRow, search->WrappedColumn);
+
+    search->Scanning = false;
+    return false;
 }
 
-void InsertCharacter(Editor* editor, char character)
+void AppendSearchProgress(Editor* editor, String* string)
 {
-    usize rowIndex = editor->FixedCursorY - 1 + editor->OffsetY;
-    String* currentRow = &editor->Rows.Values[rowIndex];
-    usize insertIndex = editor->FixedCursorX + editor->OffsetX - 1;
-    InsertChar(currentRow, insertIndex, character);
-    MoveRight(editor, 1);
+    EditorSearch* search = &editor->Search;
+    if (search->Query.Length == 0)
+        return;
+
+    if (search->Matches == 0 && !search->Scanning)
+    {
+        AppendStr(string, " (no matches)");
+        return;
+    }
+
+    AppendStr(string, " (");
+    AppendUInt(string, search->Matches);
+    AppendStr(string, search->Matches == 1 ? " match" : " matches");
+    if (search->Scanning)
+    {
+        AppendStr(string, ", ");
+        AppendUInt(string, search->ScannedRows * 100 / Max(editor->Rows.Count, 1));
+        AppendStr(string, "%");
+    }
+
+    AppendStr(string, ")");
 }
 
-void InsertTab(Editor* editor)
+void ShowSearchSummary(Editor* editor)
 {
-    usize rowIndex = editor->FixedCursorY - 1 + editor->OffsetY;
-    String* currentRow = &editor->Rows.Values[rowIndex];
-    usize insertIndex = editor->FixedCursorX + editor->OffsetX - 1;
+    String message = EmptyString;
+    AppendStringView(&message, ToStringView(&editor->Search.Query));
+    AppendSearchProgress(editor, &message);
+    PrepareStatusMessage(editor, ToStringView(&message), false);
+    FinalizeString(&message);
+}
 
-    u16 tabSize = 4 - (insertIndex % 4);
-    for (u16 index = 0; index < tabSize; index += 1)
+bool UpdateSearch(Editor* editor, StringView input, bool changed)
+{
+    EditorSearch* search = &editor->Search;
+    if (changed)
     {
-        InsertChar(currentRow, insertIndex + index, ' ');
+        search->Query.Length = 0;
+        if (input.Length > 0)
+            AppendStringView(&search->Query, input);
+        StartSearch(editor);
     }
 
-    MoveRight(editor, tabSize);
+    bool scanning = ContinueSearch(editor);
+    AppendSearchProgress(editor, &editor->PromptInfo);
+    return scanning;
 }
 
-void InsertNewLine(Editor* editor)
+void ClearSearch(Editor* editor)
 {
-    InsertToRows(&editor->Rows, EmptyString, editor->CursorY + editor->OffsetY);
+    EditorSearch* search = &editor->Search;
+    search->Query.Length = 0;
+    search->Scanning = false;
 
-    usize rowIndex = editor->FixedCursorY - 1 + editor->OffsetY;
-    String* currentRow = &editor->Rows.Values[rowIndex];
+    if (search->Regex != NULL)
+    {
+        DestroyRegexMatcher(search->Matcher);
+        DestroyRegex(search->Regex);
+        search->Matcher = NULL;
+        search->Regex = NULL;
+    }
 
-    u16 insertIndex = editor->FixedCursorX - 1 + editor->OffsetX;
-    StringView contentToEnd = MakeStringView(currentRow, insertIndex, currentRow->Length);
-    if (contentToEnd.Length > 0)
+    ClearRegexMatches(&search->RegexMatches);
+    search->RegexStale = false;
+}
+
+void InvalidateSearch(Editor* editor)
+{
+    EditorSearch* search = &editor->Search;
+    search->RegexStale = true;
+    if (!search->Scanning)
+        return;
+
+    search->ScanRow = 0;
+    search->ScannedRows = 0;
+    search->Matches = 0;
+}
+
+void FindInBuffer(Editor* editor)
+{
+    ClearSearch(editor);
+
+    EditorSearch* search = &editor->Search;
+    search->OriginRow = GetCursorRow(editor);
+    search->OriginColumn = GetCursorColumn(editor);
+
+    String prompt = EmptyString;
+    AppendStr(&prompt, "Find: ");
+    StringView out = EmptyStringView;
+    search->Prompting = true;
+    bool accepted = EditorPrompt(editor, &prompt, &out, UpdateSearch);
+    search->Prompting = false;
+    if (!accepted || out.Length == 0)
+    {
+        ClearSearch(editor);
+        SetCursorPosition(editor, search->OriginRow, search->OriginColumn);
+    }
+    else if (search->Scanning && !search->Found)
     {
-        String* nextRow = &editor->Rows.Values[rowIndex + 1];
-        AppendStringView(nextRow, contentToEnd);
-        EraseString(currentRow, insertIndex, currentRow->Length);
+        FindNextMatch(editor);
     }
 
-    MoveCursorToLineStart(editor);
-    MoveDown(editor, 1);
+    FinalizeString(&prompt);
 }
 
-void DeleteCharacter(Editor* editor)
+void RunRegexSearch(Editor* editor)
 {
-    usize rowIndex = editor->FixedCursorY - 1 + editor->OffsetY;
-    String* currentRow = &editor->Rows.Values[rowIndex];
+    if (editor->Workers == NULL)
+        editor->Workers = CreateThreadPool(0);
 
-    u16 deleteIndex = editor->FixedCursorX - 1 + editor->OffsetX;
-    if (deleteIndex > 0)
+    EditorSearch* search = &editor->Search;
+    FindRegexMatches(search->Regex, editor->Workers, editor->Rows.Values, editor->Rows.Count, &search->RegexMatches);
+    search->RegexStale = false;
+}
+
+void FindNextRegexMatch(Editor* editor, bool inclusive)
+{
+    EditorSearch* search = &editor->Search;
+    if (search->RegexStale)
+        RunRegexSearch(editor);
+
+    RegexMatches* matches = &search->RegexMatches;
+    if (matches->Count == 0)
     {
-        MoveLeft(editor, 1);
-        EraseString(currentRow, deleteIndex - 1, deleteIndex);
+        static const StringView noMatches = AsStringView("No matches.");
+        PrepareStatusMessage(editor, noMatches, false);
+        return;
     }
-    else if (rowIndex > 0)
+
+    usize row = GetCursorRow(editor);
+    usize column = GetCursorColumn(editor);
+    usize low = 0, high = matches->Count;
+    while (low < high)
     {
-        MoveUp(editor, 1);
-        MoveCursorToLineEnd(editor);
+        usize middle = low + (high - low) / 2;
+        RegexMatch* match = &matches->Values[middle];
+        bool before = match->Row < row || (match->Row == row && (inclusive ? match->Column < column : match->Column <= column));
+        if (before)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    RegexMatch* match = &matches->Values[(low < matches->Count) ? low : 0];
+    SetCursorPosition(editor, match->Row, match->Column);
+}
+
+void FindRegexInBuffer(Editor* editor)
+{
+    String prompt = EmptyString;
+    AppendStr(&prompt, "Regex: ");
+    StringView out = EmptyStringView;
+    if (!EditorPrompt(editor, &prompt, &out, NULL) || out.Length == 0)
+    {
+        FinalizeString(&prompt);
+        return;
+    }
+
+    String message = EmptyString;
+    Regex* regex = CreateRegex(out, &message);
+    FinalizeString(&prompt);
+    if (regex == NULL)
+    {
+        static const StringView regexError = AsStringView("Invalid regex: ");
+        InsertStringView(&message, 0, regexError);
+        PrepareStatusMessage(editor, ToStringView(&message), true);
+        FinalizeString(&message);
+        return;
+    }
+
+    ClearSearch(editor);
+    EditorSearch* search = &editor->Search;
+    search->Regex = regex;
+    search->Matcher = CreateRegexMatcher(regex);
+
+    u64 start = GetMonotonicTime();
+    RunRegexSearch(editor);
+    u64 elapsed = GetMonotonicTime() - start;
+
+    FindNextRegexMatch(editor, true);
+
+    AppendUInt(&message, search->RegexMatches.Count);
+    AppendStr(&message, search->RegexMatches.Count == 1 ? " match in " : " matches in ");
+    AppendUInt(&message, elapsed / 1000000);
+    AppendStr(&message, " ms (");
+    AppendUInt(&message, GetThreadPoolSize(editor->Workers));
+    AppendStr(&message, GetThreadPoolSize(editor->Workers) == 1 ? " thread)" : " threads)");
+    PrepareStatusMessage(editor, ToStringView(&message), false);
+    FinalizeString(&message);
+}
+
+void FindNextMatch(Editor* editor)
+{
+    EditorSearch* search = &editor->Search;
+    if (search->Regex != NULL)
+    {
+        FindNextRegexMatch(editor, false);
+        return;
+    }
+
+    if (search->Query.Length == 0 || editor->Rows.Count == 0)
+        return;
+
+    StringView query = ToStringView(&search->Query);
+    usize row = GetCursorRow(editor);
+    isize found = FindInRow(&editor->Rows.Values[row], GetCursorColumn(editor) + 1, query);
+    for (usize step = 1; found < 0 && step <= editor->Rows.Count; step += 1)
+    {
+        row = (row + 1) % editor->Rows.Count;
+        found = FindInRow(&editor->Rows.Values[row], 0, query);
+    }
+
+    if (found < 0)
+    {
+        static const StringView noMatches = AsStringView("No matches.");
+        PrepareStatusMessage(editor, noMatches, false);
+        return;
+    }
+
+    SetCursorPosition(editor, row, (usize)found);
+}
+
+typedef struct EditorReplaceTask
+{
+    String* Rows;
+    RegexMatch* Matches;
+    usize* Groups;
+    usize GroupCount;
+    usize GroupsPerChunk;
+    StringView Replacement;
+    String* Results;
+} EditorReplaceTask;
+
+void RebuildReplacedRows(void* context, usize index)
+{
+    EditorReplaceTask* task = (EditorReplaceTask*)context;
+    usize firstGroup = index * task->GroupsPerChunk;
+    usize endGroup = Min(firstGroup + task->GroupsPerChunk, task->GroupCount);
+    for (usize group = firstGroup; group < endGroup; group += 1)
+    {
+        usize firstMatch = task->Groups[group];
+        usize endMatch = task->Groups[group + 1];
+        String* row = &task->Rows[task->Matches[firstMatch].Row];
+
+        usize length = row->Length;
+        for (usize match = firstMatch; match < endMatch; match += 1)
+            length = length - task->Matches[match].Length + task->Replacement.Length;
+
+        String* result = &task->Results[group];
+        *result = EmptyString;
+        if (length == 0)
+            continue;
+
+        ExtendString(result, length);
+
+        usize column = 0;
+        for (usize match = firstMatch; match < endMatch; match += 1)
+        {
+            RegexMatch* current = &task->Matches[match];
+            MemoryCopy(result->Content + result->Length, row->Content + column, current->Column - column);
+            result->Length += current->Column - column;
+            MemoryCopy(result->Content + result->Length, task->Replacement.Content, task->Replacement.Length);
+            result->Length += task->Replacement.Length;
+            column = current->Column + current->Length;
+        }
+
+        MemoryCopy(result->Content + result->Length, row->Content + column, row->Length - column);
+        result->Length += row->Length - column;
+        result->Content[result->Length] = '\0';
+    }
+}
+
+Regex* CreateLiteralRegex(StringView literal)
+{
+    static const StringView metacharacters = AsStringView("\\^$.|?*+()[]{}");
+
+    String pattern = EmptyString;
+    for (usize index = 0; index < literal.Length; index += 1)
+    {
+        char character = literal.Content[index];
+        if (FindSubstring(metacharacters, (StringView){.Length = 1, .Content = &character}) >= 0)
+            AppendChar(&pattern, '\\');
+
+        AppendChar(&pattern, character);
+    }
 
-        String* previousRow = &editor->Rows.Values[rowIndex - 1];
-        StringView contentToEnd = MakeStringView(currentRow, deleteIndex, currentRow->Length);
-        if (contentToEnd.Length > 0)
+    Regex* regex = CreateRegex(ToStringView(&pattern), NULL);
+    FinalizeString(&pattern);
+    return regex;
+}
+
+usize ReplaceMatches(Editor* editor, RegexMatches* matches, StringView replacement)
+{
+    usize* groups = (usize*)MemoryAllocate((matches->Count + 1) * sizeof(usize));
+    usize groupCount = 0;
+    for (usize match = 0; match < matches->Count; match += 1)
+    {
+        if (match == 0 || matches->Values[match].Row != matches->Values[match - 1].Row)
+        {
+            groups[groupCount] = match;
+            groupCount += 1;
+        }
+    }
+
+    groups[groupCount] = matches->Count;
+
+    usize chunkCount = Min(GetThreadPoolSize(editor->Workers) * 8, groupCount);
+    EditorReplaceTask task = {
+        .Rows = editor->Rows.Values,
+        .Matches = matches->Values,
+        .Groups = groups,
+        .GroupCount = groupCount,
+        .GroupsPerChunk = (groupCount + chunkCount - 1) / chunkCount,
+        .Replacement = replacement,
+        .Results = (String*)MemoryAllocate(groupCount * sizeof(String)),
+    };
+
+    RunThreadPool(editor->Workers, RebuildReplacedRows, &task, chunkCount);
+
+    BeginHistoryBatch(&editor->History);
+    for (usize group = 0; group < groupCount; group += 1)
+    {
+        isize delta = 0;
+        for (usize match = groups[group]; match < groups[group + 1]; match += 1)
+        {
+            RegexMatch* current = &matches->Values[match];
+            HistoryOperation operation = {
+                .Kind = HISTORY_OPERATION_REPLACE,
+                .Row = current->Row,
+                .Column = (usize)((isize)current->Column + delta),
+                .Bytes = MakeStringView(&editor->Rows.Values[current->Row], current->Column, current->Column + current->Length),
+                .Replacement = replacement,
+            };
+
+            RecordHistoryBatch(&editor->History, &operation);
+            AppendJournalOperation(editor->Journal, &operation);
+            delta += (isize)replacement.Length - (isize)current->Length;
+        }
+
+        usize rowIndex = matches->Values[groups[group]].Row;
+        String* row = &editor->Rows.Values[rowIndex];
+        InvalidateSyntaxRow(&editor->Syntax, rowIndex);
+        PreserveEditorRow(editor, row);
+        FinalizeString(row);
+        *row = task.Results[group];
+        UpdateRowLayout(editor, rowIndex, matches->Values[groups[group]].Column, replacement);
+    }
+
+    EndHistoryBatch(&editor->History);
+
+    MemoryFree(task.Results);
+    MemoryFree(groups);
+    return matches->Count;
+}
+
+void ReplaceAll(Editor* editor)
+{
+    EditorSearch* search = &editor->Search;
+    if (search->Regex == NULL && search->Query.Length == 0)
+    {
+        static const StringView noSearch = AsStringView("Search with Ctrl+F or Ctrl+R first.");
+        PrepareStatusMessage(editor, noSearch, false);
+        return;
+    }
+
+    String prompt = EmptyString;
+    AppendStr(&prompt, "Replace with: ");
+    StringView out = EmptyStringView;
+    if (!EditorPrompt(editor, &prompt, &out, NULL))
+    {
+        FinalizeString(&prompt);
+        return;
+    }
+
+    ClearEditorCursors(&editor->Cursors);
+    if (editor->Workers == NULL)
+        editor->Workers = CreateThreadPool(0);
+
+    u64 start = GetMonotonicTime();
+
+    Regex* literal = NULL;
+    RegexMatches* matches = &search->RegexMatches;
+    if (search->Regex != NULL)
+    {
+        if (search->RegexStale)
+            RunRegexSearch(editor);
+    }
+    else
+    {
+        literal = CreateLiteralRegex(ToStringView(&search->Query));
+        if (literal == NULL)
+        {
+            static const StringView tooLong = AsStringView("Search is too long to replace.");
+            PrepareStatusMessage(editor, tooLong, true);
+            FinalizeString(&prompt);
+            return;
+        }
+
+        FindRegexMatches(literal, editor->Workers, editor->Rows.Values, editor->Rows.Count, matches);
+    }
+
+    usize replaced = (matches->Count > 0) ? ReplaceMatches(editor, matches, out) : 0;
+    u64 elapsed = GetMonotonicTime() - start;
+
+    if (literal != NULL)
+        DestroyRegex(literal);
+
+    FinalizeString(&prompt);
+    ClearSearch(editor);
+
+    String message = EmptyString;
+    AppendStr(&message, "Replaced ");
+    AppendUInt(&message, replaced);
+    AppendStr(&message, replaced == 1 ? " match in " : " matches in ");
+    AppendUInt(&message, elapsed / 1000000);
+    AppendStr(&message, " ms");
+    PrepareStatusMessage(editor, ToStringView(&message), false);
+    FinalizeString(&message);
+
+    if (replaced > 0 && GetCursorRow(editor) < editor->Rows.Count)
+    {
+        usize row = GetCursorRow(editor);
+        SetCursorPosition(editor, row, Min(GetCursorColumn(editor), editor->Rows.Values[row].Length));
+    }
+}
+
+void AddCursorsAtMatches(Editor* editor)
+{
+    EditorSearch* search = &editor->Search;
+    if (search->Regex == NULL && search->Query.Length == 0)
+    {
+        static const StringView noSearch = AsStringView("Search with Ctrl+F or Ctrl+R first.");
+        PrepareStatusMessage(editor, noSearch, false);
+        return;
+    }
+
+    if (editor->Workers == NULL)
+        editor->Workers = CreateThreadPool(0);
+
+    RegexMatches literalMatches;
+    InitializeRegexMatches(&literalMatches);
+
+    RegexMatches* matches = &search->RegexMatches;
+    if (search->Regex != NULL)
+    {
+        if (search->RegexStale)
+            RunRegexSearch(editor);
+    }
+    else
+    {
+        Regex* literal = CreateLiteralRegex(ToStringView(&search->Query));
+        if (literal != NULL)
+        {
+            FindRegexMatches(literal, editor->Workers, editor->Rows.Values, editor->Rows.Count, &literalMatches);
+            DestroyRegex(literal);
+        }
+
+        matches = &literalMatches;
+    }
+
+    if (matches->Count > 0)
+    {
+        usize row = GetCursorRow(editor);
+        usize column = GetCursorColumn(editor);
+        usize primary = 0;
+        while (primary < matches->Count && (matches->Values[primary].Row < row || (matches->Values[primary].Row == row && matches->Values[primary].Column < column)))
+            primary += 1;
+
+        primary = (primary < matches->Count) ? primary : 0;
+
+        EditorCursors* cursors = &editor->Cursors;
+        ClearEditorCursors(cursors);
+        for (usize index = 0; index < matches->Count; index += 1)
         {
-            AppendStringView(previousRow, contentToEnd);
+            if (index != primary)
+                AddToEditorCursors(cursors, (EditorCursor){.Row = matches->Values[index].Row, .Column = matches->Values[index].Column});
         }
 
-        RemoveFromRows(&editor->Rows, rowIndex);
+        SetCursorPosition(editor, matches->Values[primary].Row, matches->Values[primary].Column);
+    }
+
+    String message = EmptyString;
+    AppendUInt(&message, matches->Count);
+    AppendStr(&message, matches->Count == 1 ? " cursor" : " cursors");
+    PrepareStatusMessage(editor, ToStringView(&message), false);
+    FinalizeString(&message);
+
+    FinalizeRegexMatches(&literalMatches);
+}
+
+void GoToPosition(Editor* editor)
+{
+    String prompt = EmptyString;
+    AppendStr(&prompt, "Go to (line, @offset or percent%): ");
+    StringView out = EmptyStringView;
+    if (!EditorPrompt(editor, &prompt, &out, NULL) || out.Length == 0)
+    {
+        FinalizeString(&prompt);
+        return;
+    }
+
+    bool isOffset = out.Content[0] == '@';
+    bool isPercent = out.Content[out.Length - 1] == '%';
+    StringView digits = out;
+    if (isOffset)
+    {
+        digits.Content += 1;
+        digits.Length -= 1;
+    }
+    else if (isPercent)
+    {
+        digits.Length -= 1;
+    }
+
+    u64 value;
+    if (digits.Length == 0 || !TryParseUInt(digits, &value) || (isPercent && value > 100))
+    {
+        static const StringView invalidPosition = AsStringView("Invalid position.");
+        PrepareStatusMessage(editor, invalidPosition, true);
+        FinalizeString(&prompt);
+        return;
+    }
+
+    FinalizeString(&prompt);
+
+    LineIndex* lineIndex = GetLineIndex(editor);
+    usize row, column = 0;
+    if (isOffset || isPercent)
+    {
+        u64 size = GetLineIndexSize(lineIndex);
+        u64 offset = isPercent ? size / 100 * value + size % 100 * value / 100 : Min(value, size);
+        row = FindLineAtOffset(lineIndex, offset);
+        if (isOffset)
+        {
+            column = Min((usize)(offset - GetLineOffset(lineIndex, row)), editor->Rows.Values[row].Length);
+            column = GetRowDisplayByte(editor, row, GetRowDisplayColumn(editor, row, column));
+        }
+    }
+    else
+    {
+        row = (usize)Min(Max(value, 1), (u64)editor->Rows.Count) - 1;
     }
+
+    SetCursorPosition(editor, row, column);
+}
+
+void ToggleSoftWrap(Editor* editor)
+{
+    static const StringView enabled = AsStringView("Soft wrap enabled.");
+    static const StringView disabled = AsStringView("Soft wrap disabled.");
+
+    editor->SoftWrap = !editor->SoftWrap;
+    editor->OffsetSegment = 0;
+    PrepareStatusMessage(editor, editor->SoftWrap ? enabled : disabled, false);
 }
 
 void ProcessEvent(Editor* editor, Event* event)
@@ -561,6 +3220,7 @@ void ProcessEvent(Editor* editor, Event* event)
                     else if (event->Key.Value == 'W' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
                     {
                         editor->Mode = EDITOR_MODE_VIEW;
+                        BreakHistoryGroup(&editor->History);
                     }
                     else if (event->Key.Value == 'E' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
                     {
@@ -569,6 +3229,60 @@ void ProcessEvent(Editor* editor, Event* event)
                     else if (event->Key.Value == 'S' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
                     {
                         SaveFile(editor);
+                        BreakHistoryGroup(&editor->History);
+                    }
+                    else if (event->Key.Value == 'T' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        ShowMemoryStatistics(editor);
+                    }
+                    else if (event->Key.Value == 'Z' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        if (editor->Mode == EDITOR_MODE_EDIT)
+                            UndoEdit(editor);
+                    }
+                    else if (event->Key.Value == 'Y' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        if (editor->Mode == EDITOR_MODE_EDIT)
+                            RedoEdit(editor);
+                    }
+                    else if (event->Key.Value == 'F' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        FindInBuffer(editor);
+                        BreakHistoryGroup(&editor->History);
+                    }
+                    else if (event->Key.Value == 'R' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        FindRegexInBuffer(editor);
+                        BreakHistoryGroup(&editor->History);
+                    }
+                    else if (event->Key.Value == 'N' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        FindNextMatch(editor);
+                        BreakHistoryGroup(&editor->History);
+                    }
+                    else if (event->Key.Value == 'P' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        if (editor->Mode == EDITOR_MODE_EDIT)
+                            ReplaceAll(editor);
+                    }
+                    else if (event->Key.Value == 'D' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        AddCursorsAtMatches(editor);
+                        BreakHistoryGroup(&editor->History);
+                    }
+                    else if (event->Key.Value == 'B' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        AddCursorBelow(editor);
+                        BreakHistoryGroup(&editor->History);
+                    }
+                    else if (event->Key.Value == 'G' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        GoToPosition(editor);
+                        BreakHistoryGroup(&editor->History);
+                    }
+                    else if (event->Key.Value == 'O' && event->Key.Modifiers == KEY_MODIFIER_CONTROL)
+                    {
+                        ToggleSoftWrap(editor);
                     }
                     else if (editor->Mode == EDITOR_MODE_EDIT)
                     {
@@ -591,29 +3305,41 @@ void ProcessEvent(Editor* editor, Event* event)
                     break;
 
                 case KEY_CODE_UP:
-                    MoveUp(editor, 1);
+                    MoveExtraCursors(editor, event->Key.Code, 1);
+                    MoveVisualUp(editor, 1);
+                    BreakHistoryGroup(&editor->History);
                     break;
 
                 case KEY_CODE_DOWN:
-                    MoveDown(editor, 1);
+                    MoveExtraCursors(editor, event->Key.Code, 1);
+                    MoveVisualDown(editor, 1);
+                    BreakHistoryGroup(&editor->History);
                     break;
 
                 case KEY_CODE_LEFT:
-                    MoveLeft(editor, 1);
+                    MoveExtraCursors(editor, event->Key.Code, 1);
+                    MoveLeft(editor, GetCharacterSizeBeforeCursor(editor));
+                    BreakHistoryGroup(&editor->History);
                     break;
 
                 case KEY_CODE_RIGHT:
-                    MoveRight(editor, 1);
+                    MoveExtraCursors(editor, event->Key.Code, 1);
+                    MoveRight(editor, GetCharacterSizeAtCursor(editor));
+                    BreakHistoryGroup(&editor->History);
                     break;
 
                 // FIXME(alihakankurt): Maybe we should create functions for these two
                 // which prioritize the offsetting instead of the moving cursor first.
                 case KEY_CODE_PAGE_UP:
-                    MoveUp(editor, editor->Height);
+                    MoveExtraCursors(editor, event->Key.Code, editor->Height);
+                    MoveVisualUp(editor, editor->Height);
+                    BreakHistoryGroup(&editor->History);
                     break;
 
                 case KEY_CODE_PAGE_DOWN:
-                    MoveDown(editor, editor->Height);
+                    MoveExtraCursors(editor, event->Key.Code, editor->Height);
+                    MoveVisualDown(editor, editor->Height);
+                    BreakHistoryGroup(&editor->History);
                     break;
 
                 case KEY_CODE_BACKSPACE:
@@ -623,6 +3349,11 @@ void ProcessEvent(Editor* editor, Event* event)
                     }
                     break;
 
+                case KEY_CODE_ESCAPE:
+                    ClearSearch(editor);
+                    ClearEditorCursors(&editor->Cursors);
+                    break;
+
                 default:
                     break;
             }
@@ -630,17 +3361,29 @@ void ProcessEvent(Editor* editor, Event* event)
     }
 }
 
-bool EditorPrompt(Editor* editor, String* prompt, StringView* out)
+bool EditorPrompt(Editor* editor, String* prompt, StringView* out, EditorPromptCallback callback)
 {
     usize initialLength = prompt->Length;
+    bool changed = true;
 
     Event event;
-    while (true)
+    while (editor->Running)
     {
+        bool busy = false;
+        editor->PromptInfo.Length = 0;
+        if (callback != NULL)
+            busy = callback(editor, MakeStringView(prompt, initialLength, prompt->Length), changed);
+
+        changed = false;
+
         PrepareStatusMessage(editor, ToStringView(prompt), false);
+        AppendString(&editor->Status, &editor->PromptInfo);
         RefreshScreen(editor);
 
-        if (ReadEvent(editor->Terminal, &event))
+        if (busy && !HasPendingEditorEvents(editor))
+            continue;
+
+        if (ReadEditorEvent(editor, &event))
         {
             if (event.Kind != EVENT_KEY)
                 continue;
@@ -660,14 +3403,22 @@ bool EditorPrompt(Editor* editor, String* prompt, StringView* out)
 
             if (event.Key.Code == KEY_CODE_BACKSPACE && prompt->Length > initialLength)
             {
-                prompt->Length -= 1;
+                prompt->Length = Max(initialLength, FindPreviousCodepoint(ToStringView(prompt), prompt->Length));
+                prompt->Content[prompt->Length] = '\0';
+                changed = true;
                 continue;
             }
 
             if (event.Key.Code == KEY_CODE_CHARACTER)
             {
-                AppendChar(prompt, event.Key.Value);
+                char bytes[4];
+                usize length = EncodeUtf8(event.Key.Value, bytes);
+                AppendStringView(prompt, (StringView){.Length = length, .Content = bytes});
+                changed = true;
             }
         }
     }
+
+    editor->StatusTimeout = 0;
+    return false;
 }
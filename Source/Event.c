@@ -1,8 +1,9 @@
 #include <Event.h>
 
-void MakeKeyEvent(Event* event, KeyCode code, KeyModifier modifiers, char value)
+void MakeKeyEvent(Event* event, KeyCode code, KeyModifier modifiers, u32 value)
 {
     event->Kind = EVENT_KEY;
+    event->Timestamp = 0;
     event->Key.Code = code;
     event->Key.Modifiers = modifiers;
     event->Key.Value = value;
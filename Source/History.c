@@ -0,0 +1,333 @@
+#include <History.h>
+
+typedef struct HistoryRecord
+{
+    u32 Length;
+    u8 Kind;
+    u8 GroupStart;
+    u16 Reserved;
+    u64 Row;
+    u64 Column;
+} HistoryRecord;
+
+#define HISTORY_TRAILER_SIZE sizeof(u32)
+
+ImplementList(HistoryOperations, HistoryOperation)
+
+void InitializeHistory(History* history, usize capacity)
+{
+    history->Journal = EmptyString;
+    history->Position = 0;
+    history->Capacity = capacity;
+
+    history->Grouping = false;
+    history->LastRecord = 0;
+    history->LastRow = 0;
+    history->LastColumn = 0;
+    history->LastTime = 0;
+
+    history->BatchStart = false;
+}
+
+void FinalizeHistory(History* history)
+{
+    FinalizeString(&history->Journal);
+}
+
+void ReserveHistory(History* history, usize size)
+{
+    usize required = history->Journal.Length + size;
+    if (required > history->Journal.Capacity)
+        ExtendString(&history->Journal, Max(required, history->Journal.Capacity * 2));
+}
+
+HistoryRecord ReadHistoryRecord(History* history, usize offset)
+{
+    HistoryRecord record;
+    MemoryCopy(&record, history->Journal.Content + offset, sizeof(HistoryRecord));
+    return record;
+}
+
+void WriteHistoryRecord(History* history, usize offset, HistoryRecord* record)
+{
+    MemoryCopy(history->Journal.Content + offset, record, sizeof(HistoryRecord));
+}
+
+usize GetHistoryPayloadSize(HistoryOperation* operation)
+{
+    if (operation->Kind == HISTORY_OPERATION_REPLACE)
+        return sizeof(u64) + operation->Bytes.Length + operation->Replacement.Length;
+
+    return operation->Bytes.Length;
+}
+
+usize GetHistoryRecordSize(HistoryRecord* record)
+{
+    return sizeof(HistoryRecord) + record->Length + HISTORY_TRAILER_SIZE;
+}
+
+void AppendHistoryTrailer(History* history, HistoryRecord* record)
+{
+    u32 size = (u32)GetHistoryRecordSize(record);
+    MemoryCopy(history->Journal.Content + history->Journal.Length, &size, HISTORY_TRAILER_SIZE);
+    history->Journal.Length += HISTORY_TRAILER_SIZE;
+}
+
+void AppendHistoryBytes(History* history, const void* bytes, usize length)
+{
+    MemoryCopy(history->Journal.Content + history->Journal.Length, bytes, length);
+    history->Journal.Length += length;
+}
+
+void AppendHistoryRecord(History* history, HistoryRecord* record, HistoryOperation* operation)
+{
+    ReserveHistory(history, GetHistoryRecordSize(record));
+
+    WriteHistoryRecord(history, history->Journal.Length, record);
+    history->Journal.Length += sizeof(HistoryRecord);
+
+    if (operation->Kind == HISTORY_OPERATION_REPLACE)
+    {
+        u64 length = operation->Bytes.Length;
+        AppendHistoryBytes(history, &length, sizeof(u64));
+        AppendHistoryBytes(history, operation->Replacement.Content, operation->Replacement.Length);
+    }
+
+    AppendHistoryBytes(history, operation->Bytes.Content, operation->Bytes.Length);
+    AppendHistoryTrailer(history, record);
+}
+
+void GetHistoryOperationBounds(HistoryOperation* operation, usize* startRow, usize* startColumn, usize* endRow, usize* endColumn)
+{
+    switch (operation->Kind)
+    {
+        case HISTORY_OPERATION_INSERT:
+            *startRow = operation->Row;
+            *startColumn = operation->Column;
+            *endRow = operation->Row;
+            *endColumn = operation->Column + operation->Bytes.Length;
+            break;
+        case HISTORY_OPERATION_DELETE:
+            *startRow = operation->Row;
+            *startColumn = operation->Column + operation->Bytes.Length;
+            *endRow = operation->Row;
+            *endColumn = operation->Column;
+            break;
+        case HISTORY_OPERATION_SPLIT:
+            *startRow = operation->Row;
+            *startColumn = operation->Column;
+            *endRow = operation->Row + 1;
+            *endColumn = 0;
+            break;
+        case HISTORY_OPERATION_JOIN:
+            *startRow = operation->Row + 1;
+            *startColumn = 0;
+            *endRow = operation->Row;
+            *endColumn = operation->Column;
+            break;
+        case HISTORY_OPERATION_REPLACE:
+            *startRow = operation->Row;
+            *startColumn = operation->Column;
+            *endRow = operation->Row;
+            *endColumn = operation->Column + operation->Replacement.Length;
+            break;
+    }
+}
+
+bool IsHistoryInsertion(HistoryOperationKind kind)
+{
+    return kind == HISTORY_OPERATION_INSERT || kind == HISTORY_OPERATION_SPLIT;
+}
+
+void EvictHistory(History* history)
+{
+    if (history->Journal.Length <= history->Capacity)
+        return;
+
+    usize target = history->Journal.Length - history->Capacity * 3 / 4;
+    usize cut = 0;
+    for (usize offset = 0; offset < history->LastRecord;)
+    {
+        HistoryRecord record = ReadHistoryRecord(history, offset);
+        if (record.GroupStart)
+        {
+            cut = offset;
+            if (offset >= target)
+                break;
+        }
+
+        offset += GetHistoryRecordSize(&record);
+    }
+
+    if (cut == 0)
+        return;
+
+    MemoryCopy(history->Journal.Content, history->Journal.Content + cut, history->Journal.Length - cut);
+    history->Journal.Length -= cut;
+    history->Position -= cut;
+    history->LastRecord -= cut;
+}
+
+void RecordHistory(History* history, HistoryOperation* operation)
+{
+    u64 now = GetMonotonicTime();
+    history->Journal.Length = history->Position;
+
+    usize startRow = operation->Row, startColumn = operation->Column, endRow = operation->Row, endColumn = operation->Column;
+    GetHistoryOperationBounds(operation, &startRow, &startColumn, &endRow, &endColumn);
+
+    HistoryRecord last = {0};
+    bool continues = history->Grouping && now - history->LastTime < HISTORY_GROUP_TIMEOUT && startRow == history->LastRow
+                  && startColumn == history->LastColumn;
+    if (continues)
+    {
+        last = ReadHistoryRecord(history, history->LastRecord);
+        continues = IsHistoryInsertion((HistoryOperationKind)last.Kind) == IsHistoryInsertion(operation->Kind);
+    }
+
+    bool mergeable = continues && last.Kind == operation->Kind && (u64)last.Length + operation->Bytes.Length <= 0xFFFFFFFF;
+    if (mergeable && operation->Kind == HISTORY_OPERATION_INSERT)
+    {
+        history->Journal.Length -= HISTORY_TRAILER_SIZE;
+        ReserveHistory(history, operation->Bytes.Length + HISTORY_TRAILER_SIZE);
+        MemoryCopy(history->Journal.Content + history->Journal.Length, operation->Bytes.Content, operation->Bytes.Length);
+        history->Journal.Length += operation->Bytes.Length;
+
+        last.Length += (u32)operation->Bytes.Length;
+        WriteHistoryRecord(history, history->LastRecord, &last);
+        AppendHistoryTrailer(history, &last);
+    }
+    else if (mergeable && operation->Kind == HISTORY_OPERATION_DELETE)
+    {
+        history->Journal.Length -= HISTORY_TRAILER_SIZE;
+        ReserveHistory(history, operation->Bytes.Length + HISTORY_TRAILER_SIZE);
+        char* payload = history->Journal.Content + history->LastRecord + sizeof(HistoryRecord);
+        MemoryCopy(payload + operation->Bytes.Length, payload, last.Length);
+        MemoryCopy(payload, operation->Bytes.Content, operation->Bytes.Length);
+        history->Journal.Length += operation->Bytes.Length;
+
+        last.Length += (u32)operation->Bytes.Length;
+        last.Column = operation->Column;
+        WriteHistoryRecord(history, history->LastRecord, &last);
+        AppendHistoryTrailer(history, &last);
+    }
+    else
+    {
+        HistoryRecord record = {
+            .Length = (u32)GetHistoryPayloadSize(operation),
+            .Kind = (u8)operation->Kind,
+            .GroupStart = !continues,
+            .Row = operation->Row,
+            .Column = operation->Column,
+        };
+
+        history->LastRecord = history->Journal.Length;
+        AppendHistoryRecord(history, &record, operation);
+    }
+
+    history->Position = history->Journal.Length;
+    history->Grouping = true;
+    history->LastRow = endRow;
+    history->LastColumn = endColumn;
+    history->LastTime = now;
+
+    EvictHistory(history);
+}
+
+void BreakHistoryGroup(History* history)
+{
+    history->Grouping = false;
+}
+
+void BeginHistoryBatch(History* history)
+{
+    history->Journal.Length = history->Position;
+    history->Grouping = false;
+    history->BatchStart = true;
+}
+
+void RecordHistoryBatch(History* history, HistoryOperation* operation)
+{
+    HistoryRecord record = {
+        .Length = (u32)GetHistoryPayloadSize(operation),
+        .Kind = (u8)operation->Kind,
+        .GroupStart = history->BatchStart,
+        .Row = operation->Row,
+        .Column = operation->Column,
+    };
+
+    history->BatchStart = false;
+    history->LastRecord = history->Journal.Length;
+    AppendHistoryRecord(history, &record, operation);
+}
+
+void EndHistoryBatch(History* history)
+{
+    history->Position = history->Journal.Length;
+    EvictHistory(history);
+}
+
+HistoryOperation MakeHistoryOperation(History* history, usize offset, HistoryRecord* record)
+{
+    const char* payload = history->Journal.Content + offset + sizeof(HistoryRecord);
+    HistoryOperation operation = {
+        .Kind = (HistoryOperationKind)record->Kind,
+        .Row = record->Row,
+        .Column = record->Column,
+        .Bytes = {.Length = record->Length, .Content = payload},
+        .Replacement = EmptyStringView,
+    };
+
+    if (operation.Kind == HISTORY_OPERATION_REPLACE)
+    {
+        u64 length;
+        MemoryCopy(&length, payload, sizeof(u64));
+        usize replacementLength = record->Length - sizeof(u64) - (usize)length;
+        operation.Replacement = (StringView){.Length = replacementLength, .Content = payload + sizeof(u64)};
+        operation.Bytes = (StringView){.Length = (usize)length, .Content = payload + sizeof(u64) + replacementLength};
+    }
+
+    return operation;
+}
+
+bool UndoHistory(History* history, HistoryOperations* operations)
+{
+    ClearHistoryOperations(operations);
+    BreakHistoryGroup(history);
+
+    usize offset = history->Position;
+    while (offset > 0)
+    {
+        u32 size;
+        MemoryCopy(&size, history->Journal.Content + offset - HISTORY_TRAILER_SIZE, HISTORY_TRAILER_SIZE);
+        offset -= size;
+
+        HistoryRecord record = ReadHistoryRecord(history, offset);
+        AddToHistoryOperations(operations, MakeHistoryOperation(history, offset, &record));
+        if (record.GroupStart)
+            break;
+    }
+
+    history->Position = offset;
+    return operations->Count > 0;
+}
+
+bool RedoHistory(History* history, HistoryOperations* operations)
+{
+    ClearHistoryOperations(operations);
+    BreakHistoryGroup(history);
+
+    usize offset = history->Position;
+    while (offset < history->Journal.Length)
+    {
+        HistoryRecord record = ReadHistoryRecord(history, offset);
+        if (record.GroupStart && operations->Count > 0)
+            break;
+
+        AddToHistoryOperations(operations, MakeHistoryOperation(history, offset, &record));
+        offset += GetHistoryRecordSize(&record);
+    }
+
+    history->Position = offset;
+    return operations->Count > 0;
+}
@@ -1,10 +1,22 @@
 #include <IO.h>
+#include <Thread.h>
 
 #if defined(LIE_PLATFORM_LINUX) || defined(LIE_PLATFORM_MACOS)
 
+#include <errno.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+
+#if defined(LIE_PLATFORM_LINUX)
+#include <sys/inotify.h>
+#endif
 
 bool IsTTY()
 {
@@ -37,18 +49,21 @@ bool ReadFile(StringView filepath, String* destination)
     }
 
     usize fileSize = (usize)fileStat.st_size;
-    ExtendString(destination, fileSize);
+    ExtendString(destination, Max(fileSize, 1));
 
     usize readBytes = 0;
     while (readBytes < fileSize)
     {
-        isize bytesRead = read(file, destination->Content + destination->Length, fileSize - destination->Length);
+        isize bytesRead = read(file, destination->Content + readBytes, fileSize - readBytes);
         if (bytesRead < 0)
         {
             close(file);
             return false;
         }
 
+        if (bytesRead == 0)
+            break;
+
         readBytes += (usize)bytesRead;
     }
 
@@ -104,4 +119,487 @@ bool AppendFile(StringView filepath, StringView source)
     return true;
 }
 
+void RestrictFileHandle(i32 handle, StringView original)
+{
+    struct stat originalStat;
+    if (stat(original.Content, &originalStat) < 0)
+    {
+        fchmod(handle, S_IRUSR | S_IWUSR);
+        return;
+    }
+
+    if (fchown(handle, originalStat.st_uid, originalStat.st_gid) < 0)
+        fchown(handle, (uid_t)-1, originalStat.st_gid);
+
+    fchmod(handle, originalStat.st_mode & (S_IRUSR | S_IWUSR));
+}
+
+bool WritePrivateFile(StringView filepath, StringView source, StringView original, bool append)
+{
+    i32 file = open(filepath.Content, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), S_IRUSR | S_IWUSR);
+    if (file < 0)
+        return false;
+
+    RestrictFileHandle(file, original);
+
+    usize writtenBytes = 0;
+    while (writtenBytes < source.Length)
+    {
+        isize bytesWritten = write(file, source.Content + writtenBytes, source.Length - writtenBytes);
+        if (bytesWritten < 0)
+        {
+            close(file);
+            return false;
+        }
+
+        writtenBytes += (usize)bytesWritten;
+    }
+
+    close(file);
+    return true;
+}
+
+bool DeleteFile(StringView filepath)
+{
+    return unlink(filepath.Content) == 0;
+}
+
+bool GetFileInfo(StringView filepath, u64* size, u64* modified)
+{
+    struct stat fileStat;
+    if (stat(filepath.Content, &fileStat) < 0)
+        return false;
+
+    *size = (u64)fileStat.st_size;
+#if defined(LIE_PLATFORM_MACOS)
+    *modified = (u64)fileStat.st_mtimespec.tv_sec * 1000000000 + (u64)fileStat.st_mtimespec.tv_nsec;
+#else
+    *modified = (u64)fileStat.st_mtim.tv_sec * 1000000000 + (u64)fileStat.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+usize FindPathSeparator(String* path)
+{
+    usize index = path->Length;
+    while (index > 0 && path->Content[index - 1] != '/')
+        index -= 1;
+
+    return index;
+}
+
+i32 CreateTemporarySibling(FileWriter* writer)
+{
+    usize separator = FindPathSeparator(&writer->Path);
+    writer->TemporaryPath.Length = 0;
+    if (separator > 0)
+        AppendStringView(&writer->TemporaryPath, MakeStringView(&writer->Path, 0, separator));
+
+    AppendChar(&writer->TemporaryPath, '.');
+    AppendStringView(&writer->TemporaryPath, MakeStringView(&writer->Path, separator, writer->Path.Length));
+    AppendStr(&writer->TemporaryPath, ".XXXXXX");
+    return mkstemp(writer->TemporaryPath.Content);
+}
+
+void CopyFileAttributes(i32 handle, struct stat* original)
+{
+    if (original == NULL)
+    {
+        mode_t mask = umask(0);
+        umask(mask);
+        fchmod(handle, (S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) & ~mask);
+        return;
+    }
+
+    if (fchown(handle, original->st_uid, original->st_gid) < 0)
+        fchown(handle, (uid_t)-1, original->st_gid);
+
+    fchmod(handle, original->st_mode & 07777);
+}
+
+bool SyncFileHandle(i32 handle, FileDurability durability)
+{
+    if (durability == FILE_DURABILITY_NONE)
+        return true;
+
+#if defined(LIE_PLATFORM_MACOS)
+    if (durability == FILE_DURABILITY_FULL && fcntl(handle, F_FULLFSYNC) == 0)
+        return true;
+
+    return fsync(handle) == 0;
+#else
+    if (durability == FILE_DURABILITY_DATA)
+        return fdatasync(handle) == 0;
+
+    return fsync(handle) == 0;
+#endif
+}
+
+bool SyncParentDirectory(String* path)
+{
+    usize separator = FindPathSeparator(path);
+    String directory = EmptyString;
+    if (separator == 0)
+        AppendChar(&directory, '.');
+    else
+        AppendStringView(&directory, MakeStringView(path, 0, separator));
+
+    i32 handle = open(directory.Content, O_RDONLY);
+    FinalizeString(&directory);
+    if (handle < 0)
+        return false;
+
+    bool synced = fsync(handle) == 0 || errno == EINVAL;
+    close(handle);
+    return synced;
+}
+
+bool OpenFileWriter(FileWriter* writer, StringView filepath, FileDurability durability)
+{
+    writer->Failed = false;
+    writer->Durability = durability;
+    writer->Path = EmptyString;
+    writer->TemporaryPath = EmptyString;
+    writer->Count = 0;
+
+    struct stat fileStat;
+    bool exists = stat(filepath.Content, &fileStat) == 0;
+
+    char resolved[PATH_MAX];
+    if (exists && realpath(filepath.Content, resolved) != NULL)
+        AppendStr(&writer->Path, resolved);
+    else
+        AppendStringView(&writer->Path, filepath);
+
+    writer->Handle = -1;
+    if (!exists || (S_ISREG(fileStat.st_mode) && fileStat.st_nlink == 1))
+        writer->Handle = CreateTemporarySibling(writer);
+
+    writer->Replacing = writer->Handle >= 0;
+    if (writer->Replacing)
+        CopyFileAttributes(writer->Handle, exists ? &fileStat : NULL);
+    else
+        writer->Handle = open(writer->Path.Content, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    writer->Failed = writer->Handle < 0;
+    return !writer->Failed;
+}
+
+void RestrictFileWriter(FileWriter* writer, StringView original)
+{
+    if (writer->Handle >= 0)
+        RestrictFileHandle(writer->Handle, original);
+}
+
+void FlushFileWriter(FileWriter* writer)
+{
+    struct iovec vectors[FILE_WRITER_BATCH];
+    for (usize index = 0; index < writer->Count; index += 1)
+    {
+        vectors[index].iov_base = (void*)writer->Views[index].Content;
+        vectors[index].iov_len = writer->Views[index].Length;
+    }
+
+    struct iovec* current = vectors;
+    usize remaining = writer->Count;
+    writer->Count = 0;
+
+    while (remaining > 0 && !writer->Failed)
+    {
+        isize bytesWritten = writev(writer->Handle, current, (i32)remaining);
+        if (bytesWritten <= 0)
+        {
+            writer->Failed = true;
+            break;
+        }
+
+        usize written = (usize)bytesWritten;
+        while (remaining > 0 && written >= current->iov_len)
+        {
+            written -= current->iov_len;
+            current += 1;
+            remaining -= 1;
+        }
+
+        if (remaining > 0)
+        {
+            current->iov_base = (char*)current->iov_base + written;
+            current->iov_len -= written;
+        }
+    }
+}
+
+void WriteFileView(FileWriter* writer, StringView view)
+{
+    if (writer->Failed || view.Length == 0)
+        return;
+
+    writer->Views[writer->Count] = view;
+    writer->Count += 1;
+
+    if (writer->Count == FILE_WRITER_BATCH)
+        FlushFileWriter(writer);
+}
+
+bool CloseFileWriter(FileWriter* writer)
+{
+    if (writer->Handle >= 0)
+    {
+        FlushFileWriter(writer);
+        if (!writer->Failed && !SyncFileHandle(writer->Handle, writer->Durability))
+            writer->Failed = true;
+
+        if (close(writer->Handle) < 0)
+            writer->Failed = true;
+
+        if (writer->Replacing)
+        {
+            if (!writer->Failed && rename(writer->TemporaryPath.Content, writer->Path.Content) < 0)
+                writer->Failed = true;
+
+            if (writer->Failed)
+                unlink(writer->TemporaryPath.Content);
+            else if (writer->Durability == FILE_DURABILITY_FULL && !SyncParentDirectory(&writer->Path))
+                writer->Failed = true;
+        }
+    }
+
+    writer->Handle = -1;
+    FinalizeString(&writer->Path);
+    FinalizeString(&writer->TemporaryPath);
+    return !writer->Failed;
+}
+
+bool OpenFileWatcher(FileWatcher* watcher, StringView filepath, u64 offset)
+{
+    watcher->Handle = open(filepath.Content, O_RDONLY | O_CLOEXEC);
+    watcher->Notify = -1;
+    watcher->Offset = offset;
+    watcher->Pending = watcher->Handle >= 0;
+    if (watcher->Handle < 0)
+        return false;
+
+#if defined(LIE_PLATFORM_LINUX)
+    watcher->Notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher->Notify >= 0 && inotify_add_watch(watcher->Notify, filepath.Content, IN_MODIFY | IN_ATTRIB) < 0)
+    {
+        close(watcher->Notify);
+        watcher->Notify = -1;
+    }
+#endif
+
+    return true;
+}
+
+bool DrainFileNotifications(FileWatcher* watcher)
+{
+    if (watcher->Notify < 0)
+        return true;
+
+#if defined(LIE_PLATFORM_LINUX)
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool notified = false;
+    while (read(watcher->Notify, events, sizeof(events)) > 0)
+        notified = true;
+
+    return notified;
+#else
+    return true;
+#endif
+}
+
+FileChange ReadFileChanges(FileWatcher* watcher, String* destination)
+{
+    destination->Length = 0;
+    if (!DrainFileNotifications(watcher) && !watcher->Pending)
+        return FILE_CHANGE_NONE;
+
+    struct stat fileStat;
+    if (fstat(watcher->Handle, &fileStat) < 0)
+        return FILE_CHANGE_NONE;
+
+    u64 size = (u64)fileStat.st_size;
+    if (size < watcher->Offset)
+    {
+        watcher->Offset = 0;
+        watcher->Pending = true;
+        return FILE_CHANGE_TRUNCATED;
+    }
+
+    usize length = (usize)Min(size - watcher->Offset, (u64)FILE_WATCHER_READ_LIMIT);
+    watcher->Pending = false;
+    if (length == 0)
+        return FILE_CHANGE_NONE;
+
+    ExtendString(destination, length);
+    isize bytesRead = pread(watcher->Handle, destination->Content, length, (off_t)watcher->Offset);
+    if (bytesRead <= 0)
+        return FILE_CHANGE_NONE;
+
+    destination->Length = (usize)bytesRead;
+    destination->Content[destination->Length] = '\0';
+    watcher->Offset += (u64)bytesRead;
+    watcher->Pending = watcher->Offset < size;
+    return FILE_CHANGE_APPENDED;
+}
+
+void CloseFileWatcher(FileWatcher* watcher)
+{
+    if (watcher->Notify >= 0)
+        close(watcher->Notify);
+
+    if (watcher->Handle >= 0)
+        close(watcher->Handle);
+
+    watcher->Handle = -1;
+    watcher->Notify = -1;
+}
+
+struct StreamSpill
+{
+    i32 Input;
+    i32 Handle;
+    bool Failed;
+    bool Truncated;
+    atomic_bool Stopping;
+    atomic_bool Finished;
+    BackgroundThread* Reader;
+};
+
+i32 CreateSpillFile()
+{
+    const char* directory = getenv("TMPDIR");
+    String path = EmptyString;
+    AppendStr(&path, (directory != NULL && directory[0] != '\0') ? directory : "/tmp");
+    AppendStr(&path, "/lie-stdin-XXXXXX");
+
+    i32 file = mkstemp(path.Content);
+    if (file >= 0)
+        unlink(path.Content);
+
+    FinalizeString(&path);
+    return file;
+}
+
+bool WriteSpillBytes(i32 file, const char* content, usize length)
+{
+    usize writtenBytes = 0;
+    while (writtenBytes < length)
+    {
+        isize bytesWritten = write(file, content + writtenBytes, length - writtenBytes);
+        if (bytesWritten < 0 && errno != EINTR)
+            return false;
+
+        if (bytesWritten > 0)
+            writtenBytes += (usize)bytesWritten;
+    }
+
+    return true;
+}
+
+void RunStreamSpill(void* context)
+{
+    StreamSpill* spill = (StreamSpill*)context;
+    char* chunk = (char*)MemoryAllocate(STREAM_SPILL_CHUNK);
+
+    struct pollfd descriptor = {.fd = spill->Input, .events = POLLIN};
+    while (!atomic_load(&spill->Stopping))
+    {
+        if (poll(&descriptor, 1, 100) == 0)
+            continue;
+
+        isize bytesRead = read(spill->Input, chunk, STREAM_SPILL_CHUNK);
+        if (bytesRead < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+
+        if (bytesRead <= 0)
+        {
+            spill->Failed = bytesRead < 0;
+            break;
+        }
+
+        if (!WriteSpillBytes(spill->Handle, chunk, (usize)bytesRead))
+        {
+            spill->Failed = true;
+            break;
+        }
+    }
+
+    MemoryFree(chunk);
+    atomic_store(&spill->Finished, true);
+}
+
+StreamSpill* StartStreamSpill()
+{
+    if (isatty(STDIN_FILENO))
+        return NULL;
+
+    i32 terminal = open("/dev/tty", O_RDWR | O_CLOEXEC);
+    if (terminal < 0)
+        return NULL;
+
+    StreamSpill* spill = (StreamSpill*)MemoryAllocate(sizeof(StreamSpill));
+    spill->Input = dup(STDIN_FILENO);
+    spill->Handle = CreateSpillFile();
+    spill->Failed = false;
+    spill->Truncated = false;
+    if (spill->Input < 0 || spill->Handle < 0 || dup2(terminal, STDIN_FILENO) < 0)
+    {
+        if (spill->Input >= 0)
+            close(spill->Input);
+
+        if (spill->Handle >= 0)
+            close(spill->Handle);
+
+        close(terminal);
+        MemoryFree(spill);
+        return NULL;
+    }
+
+    close(terminal);
+    fcntl(spill->Input, F_SETFD, FD_CLOEXEC);
+
+    atomic_init(&spill->Stopping, false);
+    atomic_init(&spill->Finished, false);
+    spill->Reader = StartBackgroundThread(RunStreamSpill, spill);
+    return spill;
+}
+
+bool OpenSpillWatcher(StreamSpill* spill, FileWatcher* watcher)
+{
+    watcher->Handle = dup(spill->Handle);
+    watcher->Notify = -1;
+    watcher->Offset = 0;
+    watcher->Pending = watcher->Handle >= 0;
+    return watcher->Handle >= 0;
+}
+
+bool IsStreamSpillFinished(StreamSpill* spill)
+{
+    return atomic_load(&spill->Finished);
+}
+
+void StopStreamSpill(StreamSpill* spill)
+{
+    spill->Truncated = true;
+    atomic_store(&spill->Stopping, true);
+}
+
+bool IsStreamSpillTruncated(StreamSpill* spill)
+{
+    return spill->Truncated;
+}
+
+bool FinishStreamSpill(StreamSpill* spill)
+{
+    atomic_store(&spill->Stopping, true);
+    JoinBackgroundThread(spill->Reader);
+
+    bool failed = spill->Failed;
+    close(spill->Input);
+    close(spill->Handle);
+    MemoryFree(spill);
+    return !failed;
+}
+
 #endif
\ No newline at end of file
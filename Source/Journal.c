@@ -0,0 +1,416 @@
+#include <Journal.h>
+#include <IO.h>
+#include <Save.h>
+#include <Thread.h>
+
+#include <stdatomic.h>
+
+#define JOURNAL_MAGIC      "LIESWAP1"
+#define JOURNAL_MAGIC_SIZE 8
+#define JOURNAL_SUFFIX     ".lie-swap"
+
+typedef enum JournalBase
+{
+    JOURNAL_BASE_FILE = 1,
+    JOURNAL_BASE_EMBEDDED = 2,
+} JournalBase;
+
+typedef struct JournalHeader
+{
+    char Magic[JOURNAL_MAGIC_SIZE];
+    u32 Base;
+    u32 Reserved;
+    u64 FileSize;
+    u64 FileModified;
+    u64 EmbeddedSize;
+} JournalHeader;
+
+typedef struct JournalRecord
+{
+    u32 Length;
+    u8 Kind;
+    u8 Reserved[3];
+    u64 Row;
+    u64 Column;
+    u64 Removed;
+} JournalRecord;
+
+ImplementList(JournalEdits, JournalEdit)
+
+struct Journal
+{
+    String Filepath;
+    String SwapPath;
+    u64 FileSize;
+    u64 FileModified;
+    u64 BaseSize;
+    bool Created;
+    bool Disabled;
+    usize SwapBytes;
+
+    String Pending;
+    u64 PendingTime;
+    u64 Edits;
+
+    String Writing;
+    bool Truncate;
+    bool WriteFailed;
+    BackgroundThread* Writer;
+    atomic_bool Written;
+
+    SaveJob* Checkpoint;
+    usize CheckpointBytes;
+    usize CheckpointPending;
+    bool CheckpointRequested;
+
+    bool RebaseRequested;
+    u64 RebaseEdits;
+};
+
+void MakeJournalPath(StringView filepath, String* path)
+{
+    usize separator = filepath.Length;
+    while (separator > 0 && filepath.Content[separator - 1] != '/')
+        separator -= 1;
+
+    path->Length = 0;
+    if (separator > 0)
+        AppendStringView(path, (StringView){.Length = separator, .Content = filepath.Content});
+
+    AppendChar(path, '.');
+    AppendStringView(path, (StringView){.Length = filepath.Length - separator, .Content = filepath.Content + separator});
+    AppendStr(path, JOURNAL_SUFFIX);
+}
+
+JournalHeader MakeJournalHeader(Journal* journal, JournalBase base, u64 embeddedSize)
+{
+    JournalHeader header = {
+        .Base = base,
+        .Reserved = 0,
+        .FileSize = journal->FileSize,
+        .FileModified = journal->FileModified,
+        .EmbeddedSize = embeddedSize,
+    };
+
+    MemoryCopy(header.Magic, JOURNAL_MAGIC, JOURNAL_MAGIC_SIZE);
+    return header;
+}
+
+Journal* CreateJournal(StringView filepath, bool resume)
+{
+    Journal* journal = (Journal*)MemoryAllocate(sizeof(Journal));
+    MemoryClear(journal, sizeof(Journal));
+
+    AppendStringView(&journal->Filepath, filepath);
+    MakeJournalPath(filepath, &journal->SwapPath);
+    GetFileInfo(filepath, &journal->FileSize, &journal->FileModified);
+    journal->BaseSize = journal->FileSize;
+
+    u64 swapBytes = 0, swapModified = 0;
+    journal->Created = resume && GetFileInfo(ToStringView(&journal->SwapPath), &swapBytes, &swapModified);
+    journal->SwapBytes = (usize)swapBytes;
+
+    atomic_init(&journal->Written, false);
+    return journal;
+}
+
+void ReserveJournal(Journal* journal, usize size)
+{
+    usize required = journal->Pending.Length + size;
+    if (required > journal->Pending.Capacity)
+        ExtendString(&journal->Pending, Max(required, journal->Pending.Capacity * 2));
+}
+
+void AppendJournalEdit(Journal* journal, JournalEdit* edit)
+{
+    if (journal == NULL)
+        return;
+
+    journal->Edits += 1;
+    if (journal->Disabled)
+        return;
+
+    JournalRecord record = {
+        .Length = (u32)edit->Inserted.Length,
+        .Kind = (u8)edit->Kind,
+        .Row = edit->Row,
+        .Column = edit->Column,
+        .Removed = edit->Removed,
+    };
+
+    if (journal->Pending.Length == 0)
+        journal->PendingTime = GetMonotonicTime();
+
+    ReserveJournal(journal, sizeof(JournalRecord) + edit->Inserted.Length);
+    MemoryCopy(journal->Pending.Content + journal->Pending.Length, &record, sizeof(JournalRecord));
+    journal->Pending.Length += sizeof(JournalRecord);
+    MemoryCopy(journal->Pending.Content + journal->Pending.Length, edit->Inserted.Content, edit->Inserted.Length);
+    journal->Pending.Length += edit->Inserted.Length;
+}
+
+void AppendJournalOperation(Journal* journal, HistoryOperation* operation)
+{
+    JournalEdit edit = {.Kind = operation->Kind, .Row = operation->Row, .Column = operation->Column, .Removed = 0, .Inserted = EmptyStringView};
+    switch (operation->Kind)
+    {
+        case HISTORY_OPERATION_INSERT:
+            edit.Inserted = operation->Bytes;
+            break;
+        case HISTORY_OPERATION_DELETE:
+            edit.Removed = operation->Bytes.Length;
+            break;
+        case HISTORY_OPERATION_SPLIT:
+        case HISTORY_OPERATION_JOIN:
+            break;
+        case HISTORY_OPERATION_REPLACE:
+            edit.Removed = operation->Bytes.Length;
+            edit.Inserted = operation->Replacement;
+            break;
+    }
+
+    AppendJournalEdit(journal, &edit);
+}
+
+void RunJournalWrite(void* context)
+{
+    Journal* journal = (Journal*)context;
+    StringView swapPath = ToStringView(&journal->SwapPath);
+    StringView content = ToStringView(&journal->Writing);
+    journal->WriteFailed = !WritePrivateFile(swapPath, content, ToStringView(&journal->Filepath), !journal->Truncate);
+    atomic_store(&journal->Written, true);
+}
+
+void StartJournalWrite(Journal* journal)
+{
+    String writing = journal->Writing;
+    journal->Writing = journal->Pending;
+    journal->Pending = writing;
+    journal->Pending.Length = 0;
+
+    journal->Truncate = !journal->Created;
+    if (journal->Truncate)
+    {
+        JournalHeader header = MakeJournalHeader(journal, JOURNAL_BASE_FILE, 0);
+        InsertStringView(&journal->Writing, 0, (StringView){.Length = sizeof(JournalHeader), .Content = (const char*)&header});
+        journal->SwapBytes = 0;
+    }
+
+    journal->Created = true;
+    journal->SwapBytes += journal->Writing.Length;
+
+    atomic_store(&journal->Written, false);
+    journal->Writer = StartBackgroundThread(RunJournalWrite, journal);
+}
+
+void StartJournalCheckpoint(Journal* journal, String* rows, usize count)
+{
+    usize bytes = (count > 0) ? count - 1 : 0;
+    for (usize index = 0; index < count; index += 1)
+        bytes += rows[index].Length;
+
+    JournalHeader header = MakeJournalHeader(journal, JOURNAL_BASE_EMBEDDED, bytes);
+    StringView prefix = {.Length = sizeof(JournalHeader), .Content = (const char*)&header};
+
+    journal->CheckpointRequested = false;
+    journal->Checkpoint = StartPrivateSave(ToStringView(&journal->SwapPath), FILE_DURABILITY_NONE, ToStringView(&journal->Filepath), prefix, rows, count);
+    if (journal->Checkpoint == NULL)
+    {
+        journal->Disabled = true;
+        return;
+    }
+
+    journal->CheckpointBytes = sizeof(JournalHeader) + bytes;
+    journal->CheckpointPending = journal->Pending.Length;
+    journal->BaseSize = bytes;
+}
+
+void FinishJournalCheckpoint(Journal* journal)
+{
+    bool saved = FinishSave(journal->Checkpoint);
+    journal->Checkpoint = NULL;
+
+    if (!saved)
+    {
+        journal->Disabled = true;
+        return;
+    }
+
+    EraseString(&journal->Pending, 0, journal->CheckpointPending);
+    journal->PendingTime = GetMonotonicTime();
+    journal->Created = true;
+    journal->SwapBytes = journal->CheckpointBytes;
+}
+
+void WaitForJournal(Journal* journal)
+{
+    if (journal->Writer != NULL)
+    {
+        JoinBackgroundThread(journal->Writer);
+        journal->Writer = NULL;
+        if (journal->WriteFailed)
+            journal->Disabled = true;
+    }
+
+    if (journal->Checkpoint != NULL)
+        FinishJournalCheckpoint(journal);
+}
+
+void DestroyJournal(Journal* journal, bool discard)
+{
+    WaitForJournal(journal);
+    if (discard)
+    {
+        DeleteFile(ToStringView(&journal->SwapPath));
+    }
+    else if (!journal->Disabled && journal->Pending.Length > 0)
+    {
+        StartJournalWrite(journal);
+        WaitForJournal(journal);
+    }
+
+    FinalizeString(&journal->Filepath);
+    FinalizeString(&journal->SwapPath);
+    FinalizeString(&journal->Pending);
+    FinalizeString(&journal->Writing);
+    MemoryFree(journal);
+}
+
+void RebaseJournal(Journal* journal, u64 savedEdits)
+{
+    if (journal == NULL)
+        return;
+
+    journal->RebaseRequested = true;
+    journal->RebaseEdits = savedEdits;
+}
+
+void FinishJournalRebase(Journal* journal)
+{
+    journal->RebaseRequested = false;
+    GetFileInfo(ToStringView(&journal->Filepath), &journal->FileSize, &journal->FileModified);
+    if (journal->Edits != journal->RebaseEdits)
+    {
+        journal->Disabled = false;
+        journal->CheckpointRequested = true;
+        return;
+    }
+
+    DeleteFile(ToStringView(&journal->SwapPath));
+    journal->BaseSize = journal->FileSize;
+    journal->Pending.Length = 0;
+    journal->Created = false;
+    journal->Disabled = false;
+    journal->SwapBytes = 0;
+}
+
+void UpdateJournal(Journal* journal, String* rows, usize count)
+{
+    if (journal == NULL)
+        return;
+
+    if (journal->Writer != NULL && !atomic_load(&journal->Written))
+        return;
+
+    if (journal->Checkpoint != NULL && !IsSaveFinished(journal->Checkpoint))
+        return;
+
+    WaitForJournal(journal);
+
+    if (journal->RebaseRequested)
+        FinishJournalRebase(journal);
+
+    if (journal->Disabled)
+        return;
+
+    if (journal->CheckpointRequested || (journal->Created && journal->SwapBytes > Max(JOURNAL_CHECKPOINT_SIZE, journal->BaseSize * 2)))
+    {
+        StartJournalCheckpoint(journal, rows, count);
+        return;
+    }
+
+    if (journal->Pending.Length == 0)
+        return;
+
+    if (journal->Pending.Length < JOURNAL_FLUSH_SIZE && GetMonotonicTime() - journal->PendingTime < JOURNAL_FLUSH_NANOSECONDS)
+        return;
+
+    StartJournalWrite(journal);
+}
+
+void PreserveJournalRow(Journal* journal, String* row)
+{
+    if (journal != NULL && journal->Checkpoint != NULL)
+        PreserveSavedRow(journal->Checkpoint, row);
+}
+
+void CheckpointJournal(Journal* journal)
+{
+    if (journal != NULL)
+        journal->CheckpointRequested = true;
+}
+
+u64 GetJournalEditCount(Journal* journal)
+{
+    return (journal != NULL) ? journal->Edits : 0;
+}
+
+JournalStatus ReadJournal(StringView filepath, String* content, String* storage, JournalEdits* edits)
+{
+    String swapPath = EmptyString;
+    MakeJournalPath(filepath, &swapPath);
+    bool found = ReadFile(ToStringView(&swapPath), storage);
+    FinalizeString(&swapPath);
+
+    if (!found)
+        return JOURNAL_STATUS_NONE;
+
+    JournalHeader header;
+    if (storage->Length < sizeof(JournalHeader))
+        return JOURNAL_STATUS_STALE;
+
+    MemoryCopy(&header, storage->Content, sizeof(JournalHeader));
+    if (!StringViewStartsWith(ToStringView(storage), AsStringView(JOURNAL_MAGIC)))
+        return JOURNAL_STATUS_STALE;
+
+    u64 size = 0, modified = 0;
+    if (!GetFileInfo(filepath, &size, &modified) || size != header.FileSize || modified != header.FileModified)
+        return JOURNAL_STATUS_STALE;
+
+    usize offset = sizeof(JournalHeader);
+    if (header.Base == JOURNAL_BASE_EMBEDDED && header.EmbeddedSize <= storage->Length - offset)
+    {
+        content->Length = 0;
+        AppendStringView(content, MakeStringView(storage, offset, offset + (usize)header.EmbeddedSize));
+        content->Content[content->Length] = '\0';
+        offset += (usize)header.EmbeddedSize;
+    }
+    else if (header.Base != JOURNAL_BASE_FILE)
+    {
+        return JOURNAL_STATUS_STALE;
+    }
+
+    while (offset + sizeof(JournalRecord) <= storage->Length)
+    {
+        JournalRecord record;
+        MemoryCopy(&record, storage->Content + offset, sizeof(JournalRecord));
+        if (record.Kind < HISTORY_OPERATION_INSERT || record.Kind > HISTORY_OPERATION_REPLACE)
+            break;
+
+        usize start = offset + sizeof(JournalRecord);
+        if (record.Length > storage->Length - start)
+            break;
+
+        JournalEdit edit = {
+            .Kind = (HistoryOperationKind)record.Kind,
+            .Row = (usize)record.Row,
+            .Column = (usize)record.Column,
+            .Removed = (usize)record.Removed,
+            .Inserted = MakeStringView(storage, start, start + record.Length),
+        };
+
+        AddToJournalEdits(edits, edit);
+        offset = start + record.Length;
+    }
+
+    return (edits->Count > 0 || header.Base == JOURNAL_BASE_EMBEDDED) ? JOURNAL_STATUS_RECOVERED : JOURNAL_STATUS_NONE;
+}
@@ -1,13 +1,121 @@
 #include <Editor.h>
+#include <Profiler.h>
+#include <IO.h>
 
 int main(int argc, const char* argv[])
 {
-    if (argc < 2)
+    static const StringView traceOption = AsStringView("--trace=");
+    static const StringView memoryStatisticsOption = AsStringView("--memory-stats");
+    static const StringView recordOption = AsStringView("--record=");
+    static const StringView replayOption = AsStringView("--replay=");
+    static const StringView replaySpeedOption = AsStringView("--replay-speed=max");
+    static const StringView tabWidthOption = AsStringView("--tab-width=");
+    static const StringView durabilityNoneOption = AsStringView("--durability=none");
+    static const StringView durabilityDataOption = AsStringView("--durability=data");
+    static const StringView durabilityFullOption = AsStringView("--durability=full");
+    static const StringView followOption = AsStringView("--follow");
+    static const StringView streamArgument = AsStringView("-");
+
+    String filepath = EmptyString;
+    String tracePath = EmptyString;
+    bool readStream = false;
+    bool dumpMemoryStatistics = false;
+
+    EditorOptions options;
+    InitializeEditorOptions(&options);
+
+    for (int index = 1; index < argc; index += 1)
     {
-        return RunEditorWithNoFile() ? 0 : 1;
+        StringView argument = MakeStringViewFromStr(argv[index]);
+        if (StringViewStartsWith(argument, traceOption))
+        {
+            tracePath.Length = 0;
+            AppendStr(&tracePath, argv[index] + traceOption.Length);
+        }
+        else if (StringViewEquals(argument, memoryStatisticsOption))
+        {
+            dumpMemoryStatistics = true;
+        }
+        else if (StringViewStartsWith(argument, recordOption))
+        {
+            options.RecordPath.Length = 0;
+            AppendStr(&options.RecordPath, argv[index] + recordOption.Length);
+        }
+        else if (StringViewStartsWith(argument, replayOption))
+        {
+            options.ReplayPath.Length = 0;
+            AppendStr(&options.ReplayPath, argv[index] + replayOption.Length);
+        }
+        else if (StringViewEquals(argument, replaySpeedOption))
+        {
+            options.ReplaySpeed = REPLAY_SPEED_MAXIMUM;
+        }
+        else if (StringViewStartsWith(argument, tabWidthOption))
+        {
+            u64 tabWidth;
+            StringView value = MakeStringViewFromStr(argv[index] + tabWidthOption.Length);
+            if (TryParseUInt(value, &tabWidth) && tabWidth >= 1 && tabWidth <= 16)
+                options.TabWidth = (usize)tabWidth;
+        }
+        else if (StringViewEquals(argument, durabilityNoneOption))
+        {
+            options.Durability = FILE_DURABILITY_NONE;
+        }
+        else if (StringViewEquals(argument, durabilityDataOption))
+        {
+            options.Durability = FILE_DURABILITY_DATA;
+        }
+        else if (StringViewEquals(argument, durabilityFullOption))
+        {
+            options.Durability = FILE_DURABILITY_FULL;
+        }
+        else if (StringViewEquals(argument, followOption))
+        {
+            options.Follow = true;
+        }
+        else if (StringViewEquals(argument, streamArgument))
+        {
+            readStream = true;
+        }
+        else
+        {
+            filepath.Length = 0;
+            AppendStringView(&filepath, argument);
+        }
     }
 
-    String filepath = EmptyString;
-    AppendStr(&filepath, argv[1]);
-    return RunEditorWithFile(filepath) ? 0 : 1;
+    if (tracePath.Length > 0)
+    {
+        EnableProfiler(PROFILER_DEFAULT_CAPACITY);
+    }
+
+    bool status;
+    if (readStream)
+    {
+        FinalizeString(&filepath);
+        status = RunEditorWithStream(&options);
+    }
+    else if (filepath.Length == 0)
+        status = RunEditorWithNoFile(&options);
+    else
+        status = RunEditorWithFile(filepath, &options);
+
+    FinalizeEditorOptions(&options);
+
+    if (tracePath.Length > 0)
+    {
+        ExportProfilerTrace(ToStringView(&tracePath));
+        DisableProfiler();
+        FinalizeString(&tracePath);
+    }
+
+    if (dumpMemoryStatistics)
+    {
+        String report = EmptyString;
+        AppendMemoryReport(&report);
+        WriteStdOut(report.Content, report.Length);
+        FinalizeString(&report);
+    }
+
+    return status ? 0 : 1;
 }
@@ -0,0 +1,236 @@
+#include <LineIndex.h>
+
+void InitializeLineIndex(LineIndex* index, LineIndexMeasure measure, void* context)
+{
+    index->Tree = NULL;
+    index->Sizes = NULL;
+    index->Count = 0;
+    index->Capacity = 0;
+    index->Dirty = 0;
+    index->Total = 0;
+    index->Measure = measure;
+    index->Context = context;
+    index->Stale = true;
+}
+
+void FinalizeLineIndex(LineIndex* index)
+{
+    MemoryFree(index->Tree);
+    MemoryFree(index->Sizes);
+}
+
+usize GetLowestBit(usize node)
+{
+    return node & (~node + 1);
+}
+
+void ReserveLineIndex(LineIndex* index, usize rowCount)
+{
+    if (rowCount + 1 <= index->Capacity)
+        return;
+
+    usize capacity = Max(rowCount + 1, index->Capacity * 2);
+    u64* tree = (u64*)MemoryAllocate(capacity * sizeof(u64));
+    u64* sizes = (u64*)MemoryAllocate(capacity * sizeof(u64));
+    tree[0] = 0;
+    if (index->Capacity > 0)
+    {
+        MemoryCopy(tree, index->Tree, (index->Count + 1) * sizeof(u64));
+        MemoryCopy(sizes, index->Sizes, index->Count * sizeof(u64));
+    }
+
+    MemoryFree(index->Tree);
+    MemoryFree(index->Sizes);
+    index->Tree = tree;
+    index->Sizes = sizes;
+    index->Capacity = capacity;
+}
+
+void SumLineIndex(LineIndex* index)
+{
+    if (index->Dirty >= index->Count)
+        return;
+
+    usize first = index->Dirty + 1;
+    for (usize node = first; node <= index->Count; node += 1)
+        index->Tree[node] = index->Sizes[node - 1];
+
+    for (usize child = first - 1; child > 0; child -= GetLowestBit(child))
+    {
+        usize parent = child + GetLowestBit(child);
+        if (parent <= index->Count)
+            index->Tree[parent] += index->Tree[child];
+    }
+
+    for (usize node = first; node <= index->Count; node += 1)
+    {
+        usize parent = node + GetLowestBit(node);
+        if (parent <= index->Count)
+            index->Tree[parent] += index->Tree[node];
+    }
+
+    index->Dirty = index->Count;
+}
+
+void RebuildLineIndex(LineIndex* index, usize rowCount)
+{
+    ReserveLineIndex(index, rowCount);
+    index->Count = rowCount;
+    index->Total = 0;
+    for (usize row = 0; row < rowCount; row += 1)
+    {
+        index->Sizes[row] = index->Measure(index->Context, row);
+        index->Total += index->Sizes[row];
+    }
+
+    index->Dirty = 0;
+    index->Stale = false;
+    SumLineIndex(index);
+}
+
+void UpdateLineIndex(LineIndex* index, usize row)
+{
+    if (index->Stale)
+        return;
+
+    u64 size = index->Measure(index->Context, row);
+    u64 delta = size - index->Sizes[row];
+    index->Sizes[row] = size;
+    index->Total += delta;
+    if (delta == 0 || row >= index->Dirty)
+        return;
+
+    for (usize node = row + 1; node <= index->Count; node += GetLowestBit(node))
+        index->Tree[node] += delta;
+}
+
+void AppendLineIndex(LineIndex* index, usize rowCount)
+{
+    if (index->Stale || rowCount <= index->Count)
+        return;
+
+    ReserveLineIndex(index, rowCount);
+    for (usize row = index->Count; row < rowCount; row += 1)
+    {
+        index->Sizes[row] = index->Measure(index->Context, row);
+        index->Total += index->Sizes[row];
+    }
+
+    index->Dirty = Min(index->Dirty, index->Count);
+    index->Count = rowCount;
+}
+
+void InsertLineIndex(LineIndex* index, usize row)
+{
+    if (index->Stale)
+        return;
+
+    ReserveLineIndex(index, index->Count + 1);
+    MemoryCopy(index->Sizes + row + 1, index->Sizes + row, (index->Count - row) * sizeof(u64));
+    index->Count += 1;
+    index->Sizes[row] = index->Measure(index->Context, row);
+    index->Total += index->Sizes[row];
+    index->Dirty = Min(index->Dirty, row);
+}
+
+void RemoveLineIndex(LineIndex* index, usize row)
+{
+    if (index->Stale)
+        return;
+
+    index->Total -= index->Sizes[row];
+    MemoryCopy(index->Sizes + row, index->Sizes + row + 1, (index->Count - row - 1) * sizeof(u64));
+    index->Count -= 1;
+    index->Dirty = Min(index->Dirty, row);
+}
+
+void ResizeLineIndex(LineIndex* index, usize rowCount)
+{
+    if (index->Stale)
+        return;
+
+    ReserveLineIndex(index, rowCount);
+    for (usize row = rowCount; row < index->Count; row += 1)
+        index->Total -= index->Sizes[row];
+
+    for (usize row = index->Count; row < rowCount; row += 1)
+        index->Sizes[row] = 0;
+
+    index->Dirty = Min(index->Dirty, Min(index->Count, rowCount));
+    index->Count = rowCount;
+}
+
+void MoveLineIndex(LineIndex* index, usize from, usize to)
+{
+    if (index->Stale)
+        return;
+
+    index->Total += index->Sizes[from] - index->Sizes[to];
+    index->Sizes[to] = index->Sizes[from];
+    index->Dirty = Min(index->Dirty, to);
+}
+
+u64 GetLineOffset(LineIndex* index, usize row)
+{
+    row = Min(row, index->Count);
+    usize start = row;
+    if (row > index->Dirty)
+    {
+        if (row - index->Dirty > LINE_INDEX_SCAN_ROWS)
+            SumLineIndex(index);
+        else
+            start = index->Dirty;
+    }
+
+    u64 offset = 0;
+    for (usize node = start; node > 0; node -= GetLowestBit(node))
+        offset += index->Tree[node];
+
+    for (; start < row; start += 1)
+        offset += index->Sizes[start];
+
+    return offset;
+}
+
+u64 GetLineIndexSize(LineIndex* index)
+{
+    return (index->Total > 0) ? index->Total - 1 : 0;
+}
+
+usize FindLineAtOffset(LineIndex* index, u64 offset)
+{
+    if (index->Count == 0)
+        return 0;
+
+    usize limit = Min(index->Dirty, index->Count);
+    usize step = 1;
+    while (step * 2 <= limit)
+        step *= 2;
+
+    usize node = 0;
+    for (; step > 0; step /= 2)
+    {
+        if (node + step <= limit && index->Tree[node + step] <= offset)
+        {
+            node += step;
+            offset -= index->Tree[node];
+        }
+    }
+
+    if (node == limit)
+    {
+        for (usize scanned = 0; node < index->Count && index->Sizes[node] <= offset; scanned += 1)
+        {
+            if (scanned == LINE_INDEX_SCAN_ROWS)
+            {
+                SumLineIndex(index);
+                return FindLineAtOffset(index, offset + GetLineOffset(index, node));
+            }
+
+            offset -= index->Sizes[node];
+            node += 1;
+        }
+    }
+
+    return Min(node, index->Count - 1);
+}
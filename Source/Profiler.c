@@ -0,0 +1,139 @@
+#include <Profiler.h>
+#include <IO.h>
+
+#include <stdatomic.h>
+
+typedef struct ProfileEvent
+{
+    const char* Name;
+    u64 Start;
+    u64 Duration;
+    u32 Thread;
+} ProfileEvent;
+
+typedef struct Profiler
+{
+    bool Enabled;
+    u64 Origin;
+
+    usize Capacity;
+    ProfileEvent* Events;
+    atomic_size_t Head;
+
+    atomic_uint NextThread;
+} Profiler;
+
+static Profiler GlobalProfiler = {0};
+static _Thread_local u32 CurrentThread = 0;
+
+void EnableProfiler(usize capacity)
+{
+    if (GlobalProfiler.Enabled || capacity == 0)
+        return;
+
+    usize roundedCapacity = 1;
+    while (roundedCapacity < capacity)
+        roundedCapacity *= 2;
+
+    GlobalProfiler.Origin = GetMonotonicTime();
+    GlobalProfiler.Capacity = roundedCapacity;
+    GlobalProfiler.Events = (ProfileEvent*)MemoryAllocate(roundedCapacity * sizeof(ProfileEvent));
+    atomic_store(&GlobalProfiler.Head, 0);
+    atomic_store(&GlobalProfiler.NextThread, 1);
+    GlobalProfiler.Enabled = true;
+}
+
+void DisableProfiler()
+{
+    if (!GlobalProfiler.Enabled)
+        return;
+
+    GlobalProfiler.Enabled = false;
+    MemoryFree(GlobalProfiler.Events);
+    GlobalProfiler.Events = NULL;
+    GlobalProfiler.Capacity = 0;
+}
+
+bool IsProfilerEnabled()
+{
+    return GlobalProfiler.Enabled;
+}
+
+ProfileScope BeginProfileScope(const char* name)
+{
+    ProfileScope scope = {.Name = name, .Start = 0};
+    if (GlobalProfiler.Enabled)
+        scope.Start = GetMonotonicTime();
+
+    return scope;
+}
+
+void EndProfileScope(ProfileScope scope)
+{
+    if (!GlobalProfiler.Enabled || scope.Start == 0)
+        return;
+
+    u64 end = GetMonotonicTime();
+
+    if (CurrentThread == 0)
+        CurrentThread = atomic_fetch_add(&GlobalProfiler.NextThread, 1);
+
+    usize index = atomic_fetch_add_explicit(&GlobalProfiler.Head, 1, memory_order_relaxed);
+    ProfileEvent* event = &GlobalProfiler.Events[index & (GlobalProfiler.Capacity - 1)];
+    event->Name = scope.Name;
+    event->Start = scope.Start - GlobalProfiler.Origin;
+    event->Duration = end - scope.Start;
+    event->Thread = CurrentThread;
+}
+
+void AppendMicroseconds(String* string, u64 nanoseconds)
+{
+    AppendUInt(string, nanoseconds / 1000);
+    AppendChar(string, '.');
+
+    u64 fraction = nanoseconds % 1000;
+    if (fraction < 100)
+        AppendChar(string, '0');
+    if (fraction < 10)
+        AppendChar(string, '0');
+
+    AppendUInt(string, fraction);
+}
+
+bool ExportProfilerTrace(StringView filepath)
+{
+    if (!GlobalProfiler.Enabled)
+        return false;
+
+    usize head = atomic_load(&GlobalProfiler.Head);
+    usize start = (head > GlobalProfiler.Capacity) ? head - GlobalProfiler.Capacity : 0;
+
+    usize size = 64;
+    for (usize index = start; index < head; index += 1)
+        size += GetStrLength(GlobalProfiler.Events[index & (GlobalProfiler.Capacity - 1)].Name) + PROFILER_EVENT_TEXT_SIZE;
+
+    String content = EmptyString;
+    ExtendString(&content, size);
+    AppendStr(&content, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    for (usize index = start; index < head; index += 1)
+    {
+        ProfileEvent* event = &GlobalProfiler.Events[index & (GlobalProfiler.Capacity - 1)];
+
+        AppendStr(&content, "{\"name\":\"");
+        AppendStr(&content, event->Name);
+        AppendStr(&content, "\",\"cat\":\"Lie\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+        AppendUInt(&content, event->Thread);
+        AppendStr(&content, ",\"ts\":");
+        AppendMicroseconds(&content, event->Start);
+        AppendStr(&content, ",\"dur\":");
+        AppendMicroseconds(&content, event->Duration);
+        AppendStr(&content, (index + 1 < head) ? "},\n" : "}\n");
+    }
+
+    AppendStr(&content, "]}\n");
+
+    bool status = WriteFile(filepath, ToStringView(&content));
+    FinalizeString(&content);
+    return status;
+}
\ No newline at end of file
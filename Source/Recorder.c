@@ -0,0 +1,76 @@
+#include <Recorder.h>
+#include <IO.h>
+
+#define RECORDING_MAGIC       "LIEREC01"
+#define RECORDING_MAGIC_SIZE  8
+#define RECORDING_RECORD_SIZE 16
+
+ImplementList(RecordedEvents, RecordedEvent)
+
+void AppendLittleEndian(String* string, u64 value, usize size)
+{
+    for (usize index = 0; index < size; index += 1)
+        AppendChar(string, (char)((value >> (index * 8)) & 0xFF));
+}
+
+u64 ReadLittleEndian(const char* source, usize size)
+{
+    u64 value = 0;
+    for (usize index = 0; index < size; index += 1)
+        value |= (u64)(u8)source[index] << (index * 8);
+
+    return value;
+}
+
+bool SaveRecordedEvents(StringView filepath, RecordedEvents* events)
+{
+    String content = EmptyString;
+    ExtendString(&content, RECORDING_MAGIC_SIZE + events->Count * RECORDING_RECORD_SIZE);
+    AppendStr(&content, RECORDING_MAGIC);
+
+    for (usize index = 0; index < events->Count; index += 1)
+    {
+        RecordedEvent* recorded = &events->Values[index];
+        AppendLittleEndian(&content, recorded->Time, 8);
+        AppendLittleEndian(&content, (u64)recorded->Event.Kind, 1);
+        AppendLittleEndian(&content, (u64)recorded->Event.Key.Code, 1);
+        AppendLittleEndian(&content, (u64)recorded->Event.Key.Modifiers, 1);
+        AppendLittleEndian(&content, (u64)recorded->Event.Key.Value, 4);
+        AppendLittleEndian(&content, 0, 1);
+    }
+
+    bool status = WriteFile(filepath, ToStringView(&content));
+    FinalizeString(&content);
+    return status;
+}
+
+bool LoadRecordedEvents(StringView filepath, RecordedEvents* events)
+{
+    String content = EmptyString;
+    if (!ReadFile(filepath, &content))
+        return false;
+
+    StringView magic = AsStringView(RECORDING_MAGIC);
+    if (!StringViewStartsWith(ToStringView(&content), magic))
+    {
+        FinalizeString(&content);
+        return false;
+    }
+
+    for (usize offset = RECORDING_MAGIC_SIZE; offset + RECORDING_RECORD_SIZE <= content.Length; offset += RECORDING_RECORD_SIZE)
+    {
+        const char* record = content.Content + offset;
+
+        RecordedEvent recorded;
+        recorded.Time = ReadLittleEndian(record, 8);
+        recorded.Event.Kind = (EventKind)ReadLittleEndian(record + 8, 1);
+        recorded.Event.Timestamp = 0;
+        recorded.Event.Key.Code = (KeyCode)ReadLittleEndian(record + 9, 1);
+        recorded.Event.Key.Modifiers = (KeyModifier)ReadLittleEndian(record + 10, 1);
+        recorded.Event.Key.Value = (u32)ReadLittleEndian(record + 11, 4);
+        AddToRecordedEvents(events, recorded);
+    }
+
+    FinalizeString(&content);
+    return true;
+}
@@ -0,0 +1,1336 @@
+#include <Regex.h>
+#include <Search.h>
+#include <Unicode.h>
+
+#define REGEX_NONE          0xFFFFFFFF
+#define REGEX_UNBOUNDED     0xFFFFFFFF
+#define REGEX_DFA_UNKNOWN   0xFFFFFFFF
+#define REGEX_DFA_DEAD      0
+#define REGEX_DFA_MATCH     0x1
+#define REGEX_DFA_END_KNOWN 0x2
+#define REGEX_DFA_END_MATCH 0x4
+#define REGEX_PATTERN_LIMIT 4096
+#define REGEX_DEPTH_LIMIT   256
+#define REGEX_STATE_LIMIT   100000
+#define REGEX_CHUNKS_PER_THREAD 8
+#define REGEX_CODEPOINT_LIMIT   0x10FFFF
+
+typedef struct RegexByteSet
+{
+    u8 Bits[32];
+} RegexByteSet;
+
+typedef struct RegexRange
+{
+    u32 First;
+    u32 Last;
+} RegexRange;
+
+typedef enum RegexNodeKind
+{
+    REGEX_NODE_EMPTY,
+    REGEX_NODE_SET,
+    REGEX_NODE_CONCAT,
+    REGEX_NODE_ALTERNATE,
+    REGEX_NODE_REPEAT,
+    REGEX_NODE_BEGIN,
+    REGEX_NODE_END,
+} RegexNodeKind;
+
+typedef struct RegexNode
+{
+    RegexNodeKind Kind;
+    u32 Left;
+    u32 Right;
+    u32 Set;
+    u32 Min;
+    u32 Max;
+} RegexNode;
+
+typedef enum RegexStateKind
+{
+    REGEX_STATE_SET,
+    REGEX_STATE_SPLIT,
+    REGEX_STATE_BEGIN,
+    REGEX_STATE_END,
+    REGEX_STATE_MATCH,
+} RegexStateKind;
+
+typedef struct RegexState
+{
+    RegexStateKind Kind;
+    u32 Next;
+    u32 Alternative;
+    u32 Set;
+} RegexState;
+
+typedef struct RegexDfaState
+{
+    u32 First;
+    u32 Count;
+    u32 Hash;
+} RegexDfaState;
+
+DeclareList(RegexNodes, RegexNode);
+ImplementList(RegexNodes, RegexNode);
+DeclareList(RegexStates, RegexState);
+ImplementList(RegexStates, RegexState);
+DeclareList(RegexByteSets, RegexByteSet);
+ImplementList(RegexByteSets, RegexByteSet);
+DeclareList(RegexRanges, RegexRange);
+ImplementList(RegexRanges, RegexRange);
+DeclareList(RegexIndices, u32);
+ImplementList(RegexIndices, u32);
+DeclareList(RegexDfaStates, RegexDfaState);
+ImplementList(RegexDfaStates, RegexDfaState);
+DeclareList(RegexPositions, usize);
+ImplementList(RegexPositions, usize);
+ImplementList(RegexMatches, RegexMatch);
+
+struct Regex
+{
+    RegexStates States;
+    RegexByteSets Sets;
+    u32 Start;
+    u32 ReverseStart;
+    String Literal;
+};
+
+typedef struct RegexParser
+{
+    StringView Pattern;
+    usize Position;
+    usize Depth;
+
+    RegexNodes Nodes;
+    RegexByteSets* Sets;
+
+    String* Error;
+    bool Failed;
+} RegexParser;
+
+typedef struct RegexDfa
+{
+    u32 NfaStart;
+    bool Unanchored;
+
+    RegexDfaStates States;
+    RegexIndices Members;
+
+    u32* Transitions;
+    u8* Flags;
+    usize Capacity;
+
+    u32* Table;
+    usize TableCapacity;
+
+    u32 Start[2];
+} RegexDfa;
+
+struct RegexMatcher
+{
+    Regex* Regex;
+
+    RegexDfa Forward;
+    RegexDfa Reverse;
+
+    u32* Marks;
+    u32 Mark;
+    RegexIndices Stack;
+    RegexIndices Closure;
+    RegexPositions Starts;
+};
+
+typedef struct RegexChunk
+{
+    Regex* Regex;
+    String* Rows;
+    usize FirstRow;
+    usize EndRow;
+    RegexMatches Matches;
+} RegexChunk;
+
+void AddByteToSet(RegexByteSet* set, u8 value)
+{
+    set->Bits[value >> 3] |= (u8)(1 << (value & 7));
+}
+
+void AddRangeToSet(RegexByteSet* set, u8 first, u8 last)
+{
+    for (u32 value = first; value <= last; value += 1)
+        AddByteToSet(set, (u8)value);
+}
+
+bool SetContains(RegexByteSet* set, u8 value)
+{
+    return (set->Bits[value >> 3] & (1 << (value & 7))) != 0;
+}
+
+bool GetSingleByte(RegexByteSet* set, u8* value)
+{
+    usize count = 0;
+    for (u32 candidate = 0; candidate < 256 && count < 2; candidate += 1)
+    {
+        if (SetContains(set, (u8)candidate))
+        {
+            *value = (u8)candidate;
+            count += 1;
+        }
+    }
+
+    return count == 1;
+}
+
+bool MakeClassSet(char escape, RegexByteSet* set)
+{
+    MemoryClear(set, sizeof(RegexByteSet));
+    switch (escape)
+    {
+        case 'd':
+        case 'D':
+            AddRangeToSet(set, '0', '9');
+            break;
+        case 'w':
+        case 'W':
+            AddRangeToSet(set, '0', '9');
+            AddRangeToSet(set, 'A', 'Z');
+            AddRangeToSet(set, 'a', 'z');
+            AddByteToSet(set, '_');
+            break;
+        case 's':
+        case 'S':
+            AddByteToSet(set, ' ');
+            AddRangeToSet(set, '\t', '\r');
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+bool GetEscapedByte(char escape, u8* value)
+{
+    switch (escape)
+    {
+        case 't':
+            *value = '\t';
+            return true;
+        case 'n':
+            *value = '\n';
+            return true;
+        case 'r':
+            *value = '\r';
+            return true;
+        default:
+            *value = (u8)escape;
+            return (u8)escape < 0x80 && !IsDigit(escape) && !IsUppercase(escape) && !IsLowercase(escape);
+    }
+}
+
+void NormalizeRegexRanges(RegexRanges* ranges)
+{
+    for (usize index = 1; index < ranges->Count; index += 1)
+    {
+        RegexRange range = ranges->Values[index];
+        usize position = index;
+        while (position > 0 && ranges->Values[position - 1].First > range.First)
+        {
+            ranges->Values[position] = ranges->Values[position - 1];
+            position -= 1;
+        }
+
+        ranges->Values[position] = range;
+    }
+
+    usize count = 0;
+    for (usize index = 0; index < ranges->Count; index += 1)
+    {
+        RegexRange range = ranges->Values[index];
+        if (count > 0 && range.First <= ranges->Values[count - 1].Last + 1)
+            ranges->Values[count - 1].Last = Max(ranges->Values[count - 1].Last, range.Last);
+        else
+            ranges->Values[count++] = range;
+    }
+
+    ranges->Count = count;
+}
+
+void InvertRegexRanges(RegexRanges* ranges)
+{
+    NormalizeRegexRanges(ranges);
+
+    RegexRanges inverted;
+    InitializeRegexRanges(&inverted);
+
+    u32 next = 0;
+    for (usize index = 0; index < ranges->Count; index += 1)
+    {
+        if (ranges->Values[index].First > next)
+            AddToRegexRanges(&inverted, (RegexRange){.First = next, .Last = ranges->Values[index].First - 1});
+
+        next = ranges->Values[index].Last + 1;
+    }
+
+    if (next <= REGEX_CODEPOINT_LIMIT)
+        AddToRegexRanges(&inverted, (RegexRange){.First = next, .Last = REGEX_CODEPOINT_LIMIT});
+
+    FinalizeRegexRanges(ranges);
+    *ranges = inverted;
+}
+
+bool AddClassRanges(char escape, RegexRanges* ranges)
+{
+    RegexByteSet set;
+    if (!MakeClassSet(escape, &set))
+        return false;
+
+    RegexRanges members;
+    InitializeRegexRanges(&members);
+    for (u32 value = 0; value < 0x80; value += 1)
+    {
+        if (!SetContains(&set, (u8)value))
+            continue;
+
+        if (members.Count > 0 && members.Values[members.Count - 1].Last + 1 == value)
+            members.Values[members.Count - 1].Last = value;
+        else
+            AddToRegexRanges(&members, (RegexRange){.First = value, .Last = value});
+    }
+
+    if (IsUppercase(escape))
+        InvertRegexRanges(&members);
+
+    for (usize index = 0; index < members.Count; index += 1)
+        AddToRegexRanges(ranges, members.Values[index]);
+
+    FinalizeRegexRanges(&members);
+    return true;
+}
+
+void FailRegexParser(RegexParser* parser, const char* message)
+{
+    if (parser->Failed)
+        return;
+
+    parser->Failed = true;
+    if (parser->Error != NULL)
+        AppendStr(parser->Error, message);
+}
+
+bool HasRegexInput(RegexParser* parser)
+{
+    return parser->Position < parser->Pattern.Length;
+}
+
+char PeekRegexInput(RegexParser* parser)
+{
+    return parser->Pattern.Content[parser->Position];
+}
+
+u32 AddRegexNode(RegexParser* parser, RegexNodeKind kind, u32 left, u32 right)
+{
+    RegexNode node = {.Kind = kind, .Left = left, .Right = right, .Set = REGEX_NONE, .Min = 0, .Max = 0};
+    AddToRegexNodes(&parser->Nodes, node);
+    return (u32)(parser->Nodes.Count - 1);
+}
+
+u32 AddRegexSetNode(RegexParser* parser, RegexByteSet* set)
+{
+    AddToRegexByteSets(parser->Sets, *set);
+    u32 node = AddRegexNode(parser, REGEX_NODE_SET, REGEX_NONE, REGEX_NONE);
+    parser->Nodes.Values[node].Set = (u32)(parser->Sets->Count - 1);
+    return node;
+}
+
+u32 AddRegexSequences(RegexParser* parser, u32 first, u32 last, u32 node)
+{
+    if (first <= 0xDFFF && last >= 0xD800)
+    {
+        if (first < 0xD800)
+            node = AddRegexSequences(parser, first, 0xD7FF, node);
+
+        return (last > 0xDFFF) ? AddRegexSequences(parser, 0xE000, last, node) : node;
+    }
+
+    static const u32 lengthLimits[] = {0x7F, 0x7FF, 0xFFFF};
+    for (usize index = 0; index < sizeof(lengthLimits) / sizeof(lengthLimits[0]); index += 1)
+    {
+        if (first <= lengthLimits[index] && last > lengthLimits[index])
+        {
+            node = AddRegexSequences(parser, first, lengthLimits[index], node);
+            return AddRegexSequences(parser, lengthLimits[index] + 1, last, node);
+        }
+    }
+
+    char low[4], high[4];
+    usize length = EncodeUtf8(first, low);
+    EncodeUtf8(last, high);
+    for (usize index = 1; index < length; index += 1)
+    {
+        u32 mask = (1u << (6 * index)) - 1;
+        if ((first & ~mask) == (last & ~mask))
+            continue;
+
+        if ((first & mask) != 0)
+        {
+            node = AddRegexSequences(parser, first, first | mask, node);
+            return AddRegexSequences(parser, (first | mask) + 1, last, node);
+        }
+
+        if ((last & mask) != mask)
+        {
+            node = AddRegexSequences(parser, first, (last & ~mask) - 1, node);
+            return AddRegexSequences(parser, last & ~mask, last, node);
+        }
+    }
+
+    u32 sequence = REGEX_NONE;
+    for (usize index = 0; index < length; index += 1)
+    {
+        RegexByteSet set;
+        MemoryClear(&set, sizeof(RegexByteSet));
+        AddRangeToSet(&set, (u8)low[index], (u8)high[index]);
+
+        u32 byte = AddRegexSetNode(parser, &set);
+        sequence = (sequence == REGEX_NONE) ? byte : AddRegexNode(parser, REGEX_NODE_CONCAT, sequence, byte);
+    }
+
+    return (node == REGEX_NONE) ? sequence : AddRegexNode(parser, REGEX_NODE_ALTERNATE, node, sequence);
+}
+
+u32 AddRegexRangesNode(RegexParser* parser, RegexRanges* ranges)
+{
+    NormalizeRegexRanges(ranges);
+
+    RegexByteSet ascii;
+    MemoryClear(&ascii, sizeof(RegexByteSet));
+    bool hasAscii = false;
+
+    u32 node = REGEX_NONE;
+    for (usize index = 0; index < ranges->Count; index += 1)
+    {
+        RegexRange range = ranges->Values[index];
+        if (range.First < 0x80)
+        {
+            AddRangeToSet(&ascii, (u8)range.First, (u8)Min(range.Last, 0x7F));
+            hasAscii = true;
+        }
+
+        if (range.Last >= 0x80)
+            node = AddRegexSequences(parser, Max(range.First, 0x80), range.Last, node);
+    }
+
+    if (!hasAscii && node != REGEX_NONE)
+        return node;
+
+    u32 asciiNode = AddRegexSetNode(parser, &ascii);
+    return (node == REGEX_NONE) ? asciiNode : AddRegexNode(parser, REGEX_NODE_ALTERNATE, asciiNode, node);
+}
+
+u32 ReadRegexCodepoint(RegexParser* parser)
+{
+    u32 codepoint;
+    usize length = DecodeUtf8(parser->Pattern.Content + parser->Position, parser->Pattern.Length - parser->Position, &codepoint);
+    parser->Position += length;
+    return codepoint;
+}
+
+u32 ParseRegexAlternation(RegexParser* parser);
+
+u32 ParseRegexClass(RegexParser* parser)
+{
+    RegexRanges ranges;
+    InitializeRegexRanges(&ranges);
+
+    bool negated = HasRegexInput(parser) && PeekRegexInput(parser) == '^';
+    if (negated)
+        parser->Position += 1;
+
+    bool first = true;
+    while (!parser->Failed && HasRegexInput(parser) && (PeekRegexInput(parser) != ']' || first))
+    {
+        first = false;
+        u32 low = ReadRegexCodepoint(parser);
+        if (low == '\\')
+        {
+            if (!HasRegexInput(parser))
+                break;
+
+            char escape = PeekRegexInput(parser);
+            parser->Position += 1;
+            if (AddClassRanges(escape, &ranges))
+                continue;
+
+            u8 value;
+            if (!GetEscapedByte(escape, &value))
+                FailRegexParser(parser, "Unsupported escape sequence");
+
+            low = value;
+        }
+
+        u32 high = low;
+        if (parser->Position + 1 < parser->Pattern.Length && PeekRegexInput(parser) == '-'
+            && parser->Pattern.Content[parser->Position + 1] != ']')
+        {
+            parser->Position += 1;
+            high = ReadRegexCodepoint(parser);
+
+            if (high == '\\' && HasRegexInput(parser))
+            {
+                u8 value;
+                if (!GetEscapedByte(PeekRegexInput(parser), &value))
+                    FailRegexParser(parser, "Unsupported escape sequence");
+
+                high = value;
+                parser->Position += 1;
+            }
+
+            if (high < low)
+                FailRegexParser(parser, "Invalid character range");
+        }
+
+        AddToRegexRanges(&ranges, (RegexRange){.First = low, .Last = high});
+    }
+
+    if (!parser->Failed && !HasRegexInput(parser))
+        FailRegexParser(parser, "Missing closing bracket");
+
+    if (parser->Failed)
+    {
+        FinalizeRegexRanges(&ranges);
+        return REGEX_NONE;
+    }
+
+    parser->Position += 1;
+    if (negated)
+        InvertRegexRanges(&ranges);
+
+    u32 node = AddRegexRangesNode(parser, &ranges);
+    FinalizeRegexRanges(&ranges);
+    return node;
+}
+
+u32 ParseRegexAtom(RegexParser* parser)
+{
+    char character = PeekRegexInput(parser);
+    parser->Position += 1;
+
+    RegexByteSet set;
+    MemoryClear(&set, sizeof(RegexByteSet));
+
+    RegexRanges ranges;
+    InitializeRegexRanges(&ranges);
+
+    u32 node = REGEX_NONE;
+    switch (character)
+    {
+        case '(':
+        {
+            if (parser->Depth >= REGEX_DEPTH_LIMIT)
+            {
+                FailRegexParser(parser, "Pattern is nested too deeply");
+                return REGEX_NONE;
+            }
+
+            if (parser->Position + 1 < parser->Pattern.Length && PeekRegexInput(parser) == '?'
+                && parser->Pattern.Content[parser->Position + 1] == ':')
+                parser->Position += 2;
+
+            parser->Depth += 1;
+            node = ParseRegexAlternation(parser);
+            parser->Depth -= 1;
+
+            if (!parser->Failed && (!HasRegexInput(parser) || PeekRegexInput(parser) != ')'))
+                FailRegexParser(parser, "Missing closing parenthesis");
+
+            parser->Position += 1;
+            return node;
+        }
+
+        case '[':
+            return ParseRegexClass(parser);
+
+        case '.':
+            AddToRegexRanges(&ranges, (RegexRange){.First = 0, .Last = REGEX_CODEPOINT_LIMIT});
+            node = AddRegexRangesNode(parser, &ranges);
+            FinalizeRegexRanges(&ranges);
+            return node;
+
+        case '^':
+            return AddRegexNode(parser, REGEX_NODE_BEGIN, REGEX_NONE, REGEX_NONE);
+
+        case '$':
+            return AddRegexNode(parser, REGEX_NODE_END, REGEX_NONE, REGEX_NONE);
+
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            FailRegexParser(parser, "Nothing to repeat");
+            return REGEX_NONE;
+
+        case '\\':
+            if (!HasRegexInput(parser))
+            {
+                FailRegexParser(parser, "Trailing backslash");
+                return REGEX_NONE;
+            }
+
+            character = PeekRegexInput(parser);
+            parser->Position += 1;
+            if (AddClassRanges(character, &ranges))
+            {
+                node = AddRegexRangesNode(parser, &ranges);
+                FinalizeRegexRanges(&ranges);
+                return node;
+            }
+
+            u8 value;
+            if (!GetEscapedByte(character, &value))
+            {
+                FailRegexParser(parser, "Unsupported escape sequence");
+                return REGEX_NONE;
+            }
+
+            AddByteToSet(&set, value);
+            return AddRegexSetNode(parser, &set);
+
+        default:
+        {
+            usize start = parser->Position - 1;
+            parser->Position = start;
+            u32 codepoint = ReadRegexCodepoint(parser);
+            if (parser->Position - start > 1)
+                return AddRegexSequences(parser, codepoint, codepoint, REGEX_NONE);
+
+            AddByteToSet(&set, (u8)character);
+            return AddRegexSetNode(parser, &set);
+        }
+    }
+}
+
+bool ParseRegexCount(RegexParser* parser, u32* value)
+{
+    usize start = parser->Position;
+    while (HasRegexInput(parser) && IsDigit(PeekRegexInput(parser)))
+        parser->Position += 1;
+
+    u64 parsed;
+    StringView digits = {.Length = parser->Position - start, .Content = parser->Pattern.Content + start};
+    if (digits.Length == 0 || !TryParseUInt(digits, &parsed) || parsed > REGEX_REPEAT_LIMIT)
+        return false;
+
+    *value = (u32)parsed;
+    return true;
+}
+
+bool ParseRegexBounds(RegexParser* parser, u32* min, u32* max)
+{
+    if (!ParseRegexCount(parser, min))
+        return false;
+
+    *max = *min;
+    if (HasRegexInput(parser) && PeekRegexInput(parser) == ',')
+    {
+        parser->Position += 1;
+        *max = REGEX_UNBOUNDED;
+        if (HasRegexInput(parser) && PeekRegexInput(parser) != '}' && (!ParseRegexCount(parser, max) || *max < *min))
+            return false;
+    }
+
+    if (!HasRegexInput(parser) || PeekRegexInput(parser) != '}')
+        return false;
+
+    parser->Position += 1;
+    return true;
+}
+
+u32 ParseRegexRepetition(RegexParser* parser)
+{
+    u32 node = ParseRegexAtom(parser);
+    while (!parser->Failed && HasRegexInput(parser))
+    {
+        u32 min, max;
+        switch (PeekRegexInput(parser))
+        {
+            case '*':
+                min = 0;
+                max = REGEX_UNBOUNDED;
+                break;
+            case '+':
+                min = 1;
+                max = REGEX_UNBOUNDED;
+                break;
+            case '?':
+                min = 0;
+                max = 1;
+                break;
+            case '{':
+                parser->Position += 1;
+                if (!ParseRegexBounds(parser, &min, &max))
+                {
+                    FailRegexParser(parser, "Invalid repetition count");
+                    return REGEX_NONE;
+                }
+
+                parser->Position -= 1;
+                break;
+            default:
+                return node;
+        }
+
+        parser->Position += 1;
+        node = AddRegexNode(parser, REGEX_NODE_REPEAT, node, REGEX_NONE);
+        parser->Nodes.Values[node].Min = min;
+        parser->Nodes.Values[node].Max = max;
+    }
+
+    return node;
+}
+
+u32 ParseRegexConcatenation(RegexParser* parser)
+{
+    u32 node = REGEX_NONE;
+    while (!parser->Failed && HasRegexInput(parser) && PeekRegexInput(parser) != '|' && PeekRegexInput(parser) != ')')
+    {
+        u32 item = ParseRegexRepetition(parser);
+        node = (node == REGEX_NONE) ? item : AddRegexNode(parser, REGEX_NODE_CONCAT, node, item);
+    }
+
+    if (node == REGEX_NONE)
+        node = AddRegexNode(parser, REGEX_NODE_EMPTY, REGEX_NONE, REGEX_NONE);
+
+    return node;
+}
+
+u32 ParseRegexAlternation(RegexParser* parser)
+{
+    u32 node = ParseRegexConcatenation(parser);
+    while (!parser->Failed && HasRegexInput(parser) && PeekRegexInput(parser) == '|')
+    {
+        parser->Position += 1;
+        u32 right = ParseRegexConcatenation(parser);
+        node = AddRegexNode(parser, REGEX_NODE_ALTERNATE, node, right);
+    }
+
+    return node;
+}
+
+u32 AddRegexState(Regex* regex, RegexStateKind kind, u32 next, u32 alternative, u32 set)
+{
+    RegexState state = {.Kind = kind, .Next = next, .Alternative = alternative, .Set = set};
+    AddToRegexStates(&regex->States, state);
+    return (u32)(regex->States.Count - 1);
+}
+
+u32 CompileRegexNode(Regex* regex, RegexNodes* nodes, u32 index, u32 next, bool reversed)
+{
+    if (regex->States.Count > REGEX_STATE_LIMIT)
+        return next;
+
+    RegexNode node = nodes->Values[index];
+    switch (node.Kind)
+    {
+        case REGEX_NODE_EMPTY:
+            return next;
+
+        case REGEX_NODE_SET:
+            return AddRegexState(regex, REGEX_STATE_SET, next, REGEX_NONE, node.Set);
+
+        case REGEX_NODE_CONCAT:
+            if (reversed)
+                return CompileRegexNode(regex, nodes, node.Right, CompileRegexNode(regex, nodes, node.Left, next, true), true);
+
+            return CompileRegexNode(regex, nodes, node.Left, CompileRegexNode(regex, nodes, node.Right, next, false), false);
+
+        case REGEX_NODE_ALTERNATE:
+        {
+            u32 left = CompileRegexNode(regex, nodes, node.Left, next, reversed);
+            u32 right = CompileRegexNode(regex, nodes, node.Right, next, reversed);
+            return AddRegexState(regex, REGEX_STATE_SPLIT, left, right, REGEX_NONE);
+        }
+
+        case REGEX_NODE_REPEAT:
+        {
+            u32 tail = next;
+            if (node.Max == REGEX_UNBOUNDED)
+            {
+                tail = AddRegexState(regex, REGEX_STATE_SPLIT, REGEX_NONE, next, REGEX_NONE);
+                u32 body = CompileRegexNode(regex, nodes, node.Left, tail, reversed);
+                regex->States.Values[tail].Next = body;
+            }
+            else
+            {
+                for (u32 count = node.Min; count < node.Max; count += 1)
+                {
+                    u32 body = CompileRegexNode(regex, nodes, node.Left, tail, reversed);
+                    tail = AddRegexState(regex, REGEX_STATE_SPLIT, body, tail, REGEX_NONE);
+                }
+            }
+
+            for (u32 count = 0; count < node.Min; count += 1)
+                tail = CompileRegexNode(regex, nodes, node.Left, tail, reversed);
+
+            return tail;
+        }
+
+        case REGEX_NODE_BEGIN:
+            return AddRegexState(regex, reversed ? REGEX_STATE_END : REGEX_STATE_BEGIN, next, REGEX_NONE, REGEX_NONE);
+
+        case REGEX_NODE_END:
+            return AddRegexState(regex, reversed ? REGEX_STATE_BEGIN : REGEX_STATE_END, next, REGEX_NONE, REGEX_NONE);
+    }
+
+    return next;
+}
+
+bool ExtractRegexLiteral(Regex* regex, RegexNodes* nodes, u32 index, String* literal)
+{
+    RegexNode node = nodes->Values[index];
+    u8 value;
+    switch (node.Kind)
+    {
+        case REGEX_NODE_SET:
+            if (!GetSingleByte(&regex->Sets.Values[node.Set], &value))
+                return false;
+
+            AppendChar(literal, (char)value);
+            return true;
+
+        case REGEX_NODE_CONCAT:
+            return ExtractRegexLiteral(regex, nodes, node.Left, literal) && ExtractRegexLiteral(regex, nodes, node.Right, literal);
+
+        default:
+            return false;
+    }
+}
+
+Regex* CreateRegex(StringView pattern, String* error)
+{
+    if (pattern.Length > REGEX_PATTERN_LIMIT)
+    {
+        if (error != NULL)
+            AppendStr(error, "Pattern is too long");
+
+        return NULL;
+    }
+
+    Regex* regex = (Regex*)MemoryAllocate(sizeof(Regex));
+    InitializeRegexStates(&regex->States);
+    InitializeRegexByteSets(&regex->Sets);
+    regex->Literal = EmptyString;
+
+    RegexParser parser = {.Pattern = pattern, .Position = 0, .Depth = 0, .Sets = &regex->Sets, .Error = error, .Failed = false};
+    InitializeRegexNodes(&parser.Nodes);
+
+    u32 root = ParseRegexAlternation(&parser);
+    if (!parser.Failed && HasRegexInput(&parser))
+        FailRegexParser(&parser, "Unmatched closing parenthesis");
+
+    if (!parser.Failed)
+    {
+        u32 match = AddRegexState(regex, REGEX_STATE_MATCH, REGEX_NONE, REGEX_NONE, REGEX_NONE);
+        regex->Start = CompileRegexNode(regex, &parser.Nodes, root, match, false);
+        regex->ReverseStart = CompileRegexNode(regex, &parser.Nodes, root, match, true);
+        if (regex->States.Count > REGEX_STATE_LIMIT)
+            FailRegexParser(&parser, "Pattern is too large");
+
+        if (!ExtractRegexLiteral(regex, &parser.Nodes, root, &regex->Literal))
+            regex->Literal.Length = 0;
+    }
+
+    FinalizeRegexNodes(&parser.Nodes);
+    if (parser.Failed)
+    {
+        DestroyRegex(regex);
+        return NULL;
+    }
+
+    return regex;
+}
+
+void DestroyRegex(Regex* regex)
+{
+    FinalizeRegexStates(&regex->States);
+    FinalizeRegexByteSets(&regex->Sets);
+    FinalizeString(&regex->Literal);
+    MemoryFree(regex);
+}
+
+void InitializeRegexDfa(RegexDfa* dfa, u32 nfaStart, bool unanchored)
+{
+    MemoryClear(dfa, sizeof(RegexDfa));
+    dfa->NfaStart = nfaStart;
+    dfa->Unanchored = unanchored;
+    InitializeRegexDfaStates(&dfa->States);
+    InitializeRegexIndices(&dfa->Members);
+    dfa->Start[0] = REGEX_DFA_UNKNOWN;
+    dfa->Start[1] = REGEX_DFA_UNKNOWN;
+}
+
+void FinalizeRegexDfa(RegexDfa* dfa)
+{
+    FinalizeRegexDfaStates(&dfa->States);
+    FinalizeRegexIndices(&dfa->Members);
+    MemoryFree(dfa->Transitions);
+    MemoryFree(dfa->Flags);
+    MemoryFree(dfa->Table);
+}
+
+u32 HashRegexClosure(RegexIndices* closure)
+{
+    u32 hash = 2166136261u;
+    for (usize index = 0; index < closure->Count; index += 1)
+        hash = (hash ^ closure->Values[index]) * 16777619u;
+
+    return hash;
+}
+
+void InsertRegexDfaTable(RegexDfa* dfa, u32 state)
+{
+    usize mask = dfa->TableCapacity - 1;
+    usize slot = dfa->States.Values[state].Hash & mask;
+    while (dfa->Table[slot] != 0)
+        slot = (slot + 1) & mask;
+
+    dfa->Table[slot] = state + 1;
+}
+
+void GrowRegexDfa(RegexDfa* dfa)
+{
+    usize capacity = (dfa->Capacity == 0) ? 16 : dfa->Capacity * 2;
+
+    u32* transitions = (u32*)MemoryAllocate(capacity * 256 * sizeof(u32));
+    MemorySet(transitions, 0xFF, capacity * 256 * sizeof(u32));
+    u8* flags = (u8*)MemoryAllocate(capacity);
+    if (dfa->Capacity > 0)
+    {
+        MemoryCopy(transitions, dfa->Transitions, dfa->States.Count * 256 * sizeof(u32));
+        MemoryCopy(flags, dfa->Flags, dfa->States.Count);
+    }
+
+    MemoryFree(dfa->Transitions);
+    MemoryFree(dfa->Flags);
+    dfa->Transitions = transitions;
+    dfa->Flags = flags;
+    dfa->Capacity = capacity;
+
+    MemoryFree(dfa->Table);
+    dfa->TableCapacity = capacity * 2;
+    dfa->Table = (u32*)MemoryAllocate(dfa->TableCapacity * sizeof(u32));
+    MemoryClear(dfa->Table, dfa->TableCapacity * sizeof(u32));
+    for (u32 state = 0; state < dfa->States.Count; state += 1)
+        InsertRegexDfaTable(dfa, state);
+}
+
+u32 InternRegexDfaState(RegexMatcher* matcher, RegexDfa* dfa)
+{
+    RegexIndices* closure = &matcher->Closure;
+    for (usize index = 1; index < closure->Count; index += 1)
+    {
+        u32 value = closure->Values[index];
+        usize position = index;
+        while (position > 0 && closure->Values[position - 1] > value)
+        {
+            closure->Values[position] = closure->Values[position - 1];
+            position -= 1;
+        }
+
+        closure->Values[position] = value;
+    }
+
+    u32 hash = HashRegexClosure(closure);
+    if (dfa->TableCapacity > 0)
+    {
+        usize mask = dfa->TableCapacity - 1;
+        for (usize slot = hash & mask; dfa->Table[slot] != 0; slot = (slot + 1) & mask)
+        {
+            u32 candidate = dfa->Table[slot] - 1;
+            RegexDfaState* state = &dfa->States.Values[candidate];
+            if (state->Hash == hash && state->Count == closure->Count
+                && MemoryEquals(dfa->Members.Values + state->First, closure->Values, closure->Count * sizeof(u32)))
+                return candidate;
+        }
+    }
+
+    if (dfa->States.Count == dfa->Capacity)
+        GrowRegexDfa(dfa);
+
+    RegexDfaState state = {.First = (u32)dfa->Members.Count, .Count = (u32)closure->Count, .Hash = hash};
+    u8 flags = 0;
+    for (usize index = 0; index < closure->Count; index += 1)
+    {
+        AddToRegexIndices(&dfa->Members, closure->Values[index]);
+        if (matcher->Regex->States.Values[closure->Values[index]].Kind == REGEX_STATE_MATCH)
+            flags = REGEX_DFA_MATCH;
+    }
+
+    u32 index = (u32)dfa->States.Count;
+    AddToRegexDfaStates(&dfa->States, state);
+    dfa->Flags[index] = flags;
+    InsertRegexDfaTable(dfa, index);
+    return index;
+}
+
+void ResetRegexDfa(RegexMatcher* matcher, RegexDfa* dfa)
+{
+    ClearRegexDfaStates(&dfa->States);
+    ClearRegexIndices(&dfa->Members);
+    MemorySet(dfa->Transitions, 0xFF, dfa->Capacity * 256 * sizeof(u32));
+    MemoryClear(dfa->Table, dfa->TableCapacity * sizeof(u32));
+    dfa->Start[0] = REGEX_DFA_UNKNOWN;
+    dfa->Start[1] = REGEX_DFA_UNKNOWN;
+
+    RegexIndices closure = matcher->Closure;
+    ClearRegexIndices(&matcher->Closure);
+    InternRegexDfaState(matcher, dfa);
+    matcher->Closure = closure;
+}
+
+void BeginRegexClosure(RegexMatcher* matcher)
+{
+    matcher->Mark += 1;
+    if (matcher->Mark == 0)
+    {
+        MemoryClear(matcher->Marks, matcher->Regex->States.Count * sizeof(u32));
+        matcher->Mark = 1;
+    }
+
+    ClearRegexIndices(&matcher->Closure);
+}
+
+void AddRegexClosure(RegexMatcher* matcher, u32 start, bool atLineStart)
+{
+    RegexState* states = matcher->Regex->States.Values;
+    ClearRegexIndices(&matcher->Stack);
+    AddToRegexIndices(&matcher->Stack, start);
+
+    while (matcher->Stack.Count > 0)
+    {
+        matcher->Stack.Count -= 1;
+        u32 index = matcher->Stack.Values[matcher->Stack.Count];
+        if (matcher->Marks[index] == matcher->Mark)
+            continue;
+
+        matcher->Marks[index] = matcher->Mark;
+        switch (states[index].Kind)
+        {
+            case REGEX_STATE_SET:
+            case REGEX_STATE_END:
+            case REGEX_STATE_MATCH:
+                AddToRegexIndices(&matcher->Closure, index);
+                break;
+            case REGEX_STATE_SPLIT:
+                AddToRegexIndices(&matcher->Stack, states[index].Alternative);
+                AddToRegexIndices(&matcher->Stack, states[index].Next);
+                break;
+            case REGEX_STATE_BEGIN:
+                if (atLineStart)
+                    AddToRegexIndices(&matcher->Stack, states[index].Next);
+                break;
+        }
+    }
+}
+
+u32 GetRegexDfaStart(RegexMatcher* matcher, RegexDfa* dfa, bool atLineStart)
+{
+    if (dfa->Start[atLineStart] != REGEX_DFA_UNKNOWN)
+        return dfa->Start[atLineStart];
+
+    BeginRegexClosure(matcher);
+    AddRegexClosure(matcher, dfa->NfaStart, atLineStart);
+    if (dfa->States.Count >= REGEX_DFA_STATE_LIMIT)
+        ResetRegexDfa(matcher, dfa);
+
+    dfa->Start[atLineStart] = InternRegexDfaState(matcher, dfa);
+    return dfa->Start[atLineStart];
+}
+
+u32 ComputeRegexDfaStep(RegexMatcher* matcher, RegexDfa* dfa, u32 from, u8 value)
+{
+    RegexState* states = matcher->Regex->States.Values;
+    RegexDfaState source = dfa->States.Values[from];
+
+    BeginRegexClosure(matcher);
+    for (u32 index = 0; index < source.Count; index += 1)
+    {
+        RegexState* state = &states[dfa->Members.Values[source.First + index]];
+        if (state->Kind == REGEX_STATE_SET && SetContains(&matcher->Regex->Sets.Values[state->Set], value))
+            AddRegexClosure(matcher, state->Next, false);
+    }
+
+    if (dfa->Unanchored)
+        AddRegexClosure(matcher, dfa->NfaStart, false);
+
+    if (dfa->States.Count >= REGEX_DFA_STATE_LIMIT)
+    {
+        ResetRegexDfa(matcher, dfa);
+        return InternRegexDfaState(matcher, dfa);
+    }
+
+    u32 next = InternRegexDfaState(matcher, dfa);
+    dfa->Transitions[(usize)from * 256 + value] = next;
+    return next;
+}
+
+bool MatchesRegexAtEnd(RegexMatcher* matcher, RegexDfa* dfa, u32 state)
+{
+    u8 flags = dfa->Flags[state];
+    if ((flags & REGEX_DFA_END_KNOWN) != 0)
+        return (flags & REGEX_DFA_END_MATCH) != 0;
+
+    RegexState* states = matcher->Regex->States.Values;
+    RegexDfaState source = dfa->States.Values[state];
+
+    bool matches = false;
+    BeginRegexClosure(matcher);
+    ClearRegexIndices(&matcher->Stack);
+    for (u32 index = 0; index < source.Count; index += 1)
+        AddToRegexIndices(&matcher->Stack, dfa->Members.Values[source.First + index]);
+
+    while (matcher->Stack.Count > 0 && !matches)
+    {
+        matcher->Stack.Count -= 1;
+        u32 index = matcher->Stack.Values[matcher->Stack.Count];
+        if (matcher->Marks[index] == matcher->Mark)
+            continue;
+
+        matcher->Marks[index] = matcher->Mark;
+        switch (states[index].Kind)
+        {
+            case REGEX_STATE_MATCH:
+                matches = true;
+                break;
+            case REGEX_STATE_SPLIT:
+                AddToRegexIndices(&matcher->Stack, states[index].Alternative);
+                AddToRegexIndices(&matcher->Stack, states[index].Next);
+                break;
+            case REGEX_STATE_END:
+                AddToRegexIndices(&matcher->Stack, states[index].Next);
+                break;
+            default:
+                break;
+        }
+    }
+
+    dfa->Flags[state] |= (u8)(REGEX_DFA_END_KNOWN | (matches ? REGEX_DFA_END_MATCH : 0));
+    return matches;
+}
+
+u32 StepRegexDfa(RegexMatcher* matcher, RegexDfa* dfa, u32 state, u8 value)
+{
+    u32 next = dfa->Transitions[(usize)state * 256 + value];
+    return (next != REGEX_DFA_UNKNOWN) ? next : ComputeRegexDfaStep(matcher, dfa, state, value);
+}
+
+RegexMatcher* CreateRegexMatcher(Regex* regex)
+{
+    RegexMatcher* matcher = (RegexMatcher*)MemoryAllocate(sizeof(RegexMatcher));
+    matcher->Regex = regex;
+
+    matcher->Marks = (u32*)MemoryAllocate(regex->States.Count * sizeof(u32));
+    MemoryClear(matcher->Marks, regex->States.Count * sizeof(u32));
+    matcher->Mark = 0;
+    InitializeRegexIndices(&matcher->Stack);
+    InitializeRegexIndices(&matcher->Closure);
+    InitializeRegexPositions(&matcher->Starts);
+
+    InitializeRegexDfa(&matcher->Forward, regex->Start, false);
+    InitializeRegexDfa(&matcher->Reverse, regex->ReverseStart, true);
+    BeginRegexClosure(matcher);
+    InternRegexDfaState(matcher, &matcher->Forward);
+    return matcher;
+}
+
+void DestroyRegexMatcher(RegexMatcher* matcher)
+{
+    FinalizeRegexDfa(&matcher->Forward);
+    FinalizeRegexDfa(&matcher->Reverse);
+    FinalizeRegexIndices(&matcher->Closure);
+    FinalizeRegexIndices(&matcher->Stack);
+    FinalizeRegexPositions(&matcher->Starts);
+    MemoryFree(matcher->Marks);
+    MemoryFree(matcher);
+}
+
+bool IsRegexStart(RegexMatcher* matcher, u32 state, usize position)
+{
+    RegexDfa* dfa = &matcher->Reverse;
+    return (dfa->Flags[state] & REGEX_DFA_MATCH) != 0 || (position == 0 && MatchesRegexAtEnd(matcher, dfa, state));
+}
+
+bool FindRegexStart(RegexMatcher* matcher, StringView line, usize from, usize* start)
+{
+    RegexDfa* dfa = &matcher->Reverse;
+    u32 state = GetRegexDfaStart(matcher, dfa, true);
+
+    bool found = false;
+    const u8* bytes = (const u8*)line.Content;
+    for (usize position = line.Length; position > from; position -= 1)
+    {
+        if (IsRegexStart(matcher, state, position))
+        {
+            found = true;
+            *start = position;
+        }
+
+        state = StepRegexDfa(matcher, dfa, state, bytes[position - 1]);
+    }
+
+    if (IsRegexStart(matcher, state, from))
+    {
+        found = true;
+        *start = from;
+    }
+
+    return found;
+}
+
+void CollectRegexStarts(RegexMatcher* matcher, StringView line, RegexPositions* starts)
+{
+    RegexDfa* dfa = &matcher->Reverse;
+    u32 state = GetRegexDfaStart(matcher, dfa, true);
+
+    ClearRegexPositions(starts);
+    const u8* bytes = (const u8*)line.Content;
+    const u32* transitions = dfa->Transitions;
+    const u8* flags = dfa->Flags;
+    for (usize position = line.Length; position > 0; position -= 1)
+    {
+        if ((flags[state] & REGEX_DFA_MATCH) != 0)
+            AddToRegexPositions(starts, position);
+
+        u32 next = transitions[(usize)state * 256 + bytes[position - 1]];
+        if (next == REGEX_DFA_UNKNOWN)
+        {
+            next = ComputeRegexDfaStep(matcher, dfa, state, bytes[position - 1]);
+            transitions = dfa->Transitions;
+            flags = dfa->Flags;
+        }
+
+        state = next;
+    }
+
+    if (IsRegexStart(matcher, state, 0))
+        AddToRegexPositions(starts, 0);
+}
+
+usize MatchRegexAt(RegexMatcher* matcher, StringView line, usize start)
+{
+    RegexDfa* dfa = &matcher->Forward;
+    u32 state = GetRegexDfaStart(matcher, dfa, start == 0);
+
+    usize end = start;
+    const u8* bytes = (const u8*)line.Content;
+    for (usize index = start; index < line.Length && state != REGEX_DFA_DEAD; index += 1)
+    {
+        if ((dfa->Flags[state] & REGEX_DFA_MATCH) != 0)
+            end = index;
+
+        state = StepRegexDfa(matcher, dfa, state, bytes[index]);
+    }
+
+    if (state != REGEX_DFA_DEAD && ((dfa->Flags[state] & REGEX_DFA_MATCH) != 0 || MatchesRegexAtEnd(matcher, dfa, state)))
+        end = line.Length;
+
+    return end;
+}
+
+bool FindRegexInLine(RegexMatcher* matcher, StringView line, usize from, usize* start, usize* end)
+{
+    StringView literal = ToStringView(&matcher->Regex->Literal);
+    if (literal.Length > 0 && from <= line.Length)
+    {
+        StringView rest = {.Length = line.Length - from, .Content = line.Content + from};
+        isize found = FindSubstring(rest, literal);
+        *start = from + (usize)found;
+        *end = *start + literal.Length;
+        return found >= 0;
+    }
+
+    if (from > line.Length || !FindRegexStart(matcher, line, from, start))
+        return false;
+
+    *end = MatchRegexAt(matcher, line, *start);
+    return true;
+}
+
+void FindRegexMatchesInChunk(void* context, usize index)
+{
+    RegexChunk* chunk = &((RegexChunk*)context)[index];
+    RegexMatcher* matcher = CreateRegexMatcher(chunk->Regex);
+
+    RegexPositions* starts = &matcher->Starts;
+    bool literal = chunk->Regex->Literal.Length > 0;
+    for (usize row = chunk->FirstRow; row < chunk->EndRow; row += 1)
+    {
+        StringView line = ToStringView(&chunk->Rows[row]);
+        if (literal)
+        {
+            usize from = 0, start, end;
+            while (FindRegexInLine(matcher, line, from, &start, &end))
+            {
+                RegexMatch match = {.Row = row, .Column = start, .Length = end - start};
+                AddToRegexMatches(&chunk->Matches, match);
+                from = end;
+            }
+
+            continue;
+        }
+
+        CollectRegexStarts(matcher, line, starts);
+
+        usize from = 0;
+        for (usize remaining = starts->Count; remaining > 0; remaining -= 1)
+        {
+            usize start = starts->Values[remaining - 1];
+            if (start < from)
+                continue;
+
+            usize end = MatchRegexAt(matcher, line, start);
+            if (end > start)
+            {
+                RegexMatch match = {.Row = row, .Column = start, .Length = end - start};
+                AddToRegexMatches(&chunk->Matches, match);
+                from = end;
+            }
+        }
+    }
+
+    DestroyRegexMatcher(matcher);
+}
+
+void FindRegexMatches(Regex* regex, ThreadPool* pool, String* rows, usize rowCount, RegexMatches* matches)
+{
+    ClearRegexMatches(matches);
+    if (rowCount == 0)
+        return;
+
+    usize chunkCount = Min(GetThreadPoolSize(pool) * REGEX_CHUNKS_PER_THREAD, (rowCount + REGEX_CHUNK_ROWS - 1) / REGEX_CHUNK_ROWS);
+    chunkCount = Max(chunkCount, 1);
+    usize chunkRows = (rowCount + chunkCount - 1) / chunkCount;
+
+    RegexChunk* chunks = (RegexChunk*)MemoryAllocate(chunkCount * sizeof(RegexChunk));
+    for (usize index = 0; index < chunkCount; index += 1)
+    {
+        chunks[index].Regex = regex;
+        chunks[index].Rows = rows;
+        chunks[index].FirstRow = Min(index * chunkRows, rowCount);
+        chunks[index].EndRow = Min(chunks[index].FirstRow + chunkRows, rowCount);
+        InitializeRegexMatches(&chunks[index].Matches);
+    }
+
+    RunThreadPool(pool, FindRegexMatchesInChunk, chunks, chunkCount);
+
+    for (usize index = 0; index < chunkCount; index += 1)
+    {
+        RegexMatches* chunkMatches = &chunks[index].Matches;
+        for (usize match = 0; match < chunkMatches->Count; match += 1)
+            AddToRegexMatches(matches, chunkMatches->Values[match]);
+
+        FinalizeRegexMatches(chunkMatches);
+    }
+
+    MemoryFree(chunks);
+}
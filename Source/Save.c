@@ -0,0 +1,216 @@
+#include <Save.h>
+#include <Thread.h>
+#include <List.h>
+
+#include <stdatomic.h>
+
+DeclareList(SaveCopies, char*);
+ImplementList(SaveCopies, char*);
+
+struct SaveJob
+{
+    FileWriter Writer;
+    String Prefix;
+    BackgroundThread* Thread;
+    ThreadLock* Lock;
+
+    StringView* Rows;
+    usize RowCount;
+    usize TotalBytes;
+
+    usize* Slots;
+    usize SlotMask;
+    SaveCopies Copies;
+
+    _Atomic usize WrittenBytes;
+    atomic_bool Finished;
+};
+
+usize HashSavedRow(const char* content)
+{
+    return (usize)(((u64)(usize)content >> 4) * 0x9E3779B97F4A7C15 >> 17);
+}
+
+void IndexSavedRows(SaveJob* job)
+{
+    usize capacity = 16;
+    while (capacity < job->RowCount * 2)
+        capacity *= 2;
+
+    job->SlotMask = capacity - 1;
+    job->Slots = (usize*)MemoryAllocate(capacity * sizeof(usize));
+    MemoryClear(job->Slots, capacity * sizeof(usize));
+
+    for (usize index = 0; index < job->RowCount; index += 1)
+    {
+        if (job->Rows[index].Length == 0)
+            continue;
+
+        usize slot = HashSavedRow(job->Rows[index].Content) & job->SlotMask;
+        while (job->Slots[slot] != 0)
+            slot = (slot + 1) & job->SlotMask;
+
+        job->Slots[slot] = index + 1;
+    }
+}
+
+usize FindSavedRow(SaveJob* job, const char* content)
+{
+    usize slot = HashSavedRow(content) & job->SlotMask;
+    while (job->Slots[slot] != 0)
+    {
+        usize index = job->Slots[slot] - 1;
+        if (job->Rows[index].Content == content)
+            return index;
+
+        slot = (slot + 1) & job->SlotMask;
+    }
+
+    return job->RowCount;
+}
+
+void RunSaveJob(void* context)
+{
+    static const StringView newline = AsStringView("\n");
+
+    SaveJob* job = (SaveJob*)context;
+    WriteFileView(&job->Writer, ToStringView(&job->Prefix));
+    FlushFileWriter(&job->Writer);
+
+    usize row = 0;
+    usize offset = 0;
+    while (row < job->RowCount && !job->Writer.Failed)
+    {
+        usize length = 0;
+        AcquireThreadLock(job->Lock);
+        while (row < job->RowCount && length < SAVE_BATCH_SIZE && job->Writer.Count + 2 < FILE_WRITER_BATCH)
+        {
+            StringView view = job->Rows[row];
+            usize size = Min(view.Length - offset, SAVE_BATCH_SIZE - length);
+            WriteFileView(&job->Writer, (StringView){.Length = size, .Content = view.Content + offset});
+            length += size;
+            offset += size;
+
+            if (offset == view.Length)
+            {
+                if (row + 1 < job->RowCount)
+                {
+                    WriteFileView(&job->Writer, newline);
+                    length += 1;
+                }
+
+                row += 1;
+                offset = 0;
+            }
+        }
+
+        FlushFileWriter(&job->Writer);
+        ReleaseThreadLock(job->Lock);
+        atomic_fetch_add(&job->WrittenBytes, length);
+    }
+
+    CloseFileWriter(&job->Writer);
+    atomic_store(&job->Finished, true);
+}
+
+SaveJob* StartSaveJob(StringView filepath, FileDurability durability, StringView original, StringView prefix, String* rows, usize count)
+{
+    SaveJob* job = (SaveJob*)MemoryAllocate(sizeof(SaveJob));
+    if (!OpenFileWriter(&job->Writer, filepath, durability))
+    {
+        CloseFileWriter(&job->Writer);
+        MemoryFree(job);
+        return NULL;
+    }
+
+    if (original.Length > 0)
+        RestrictFileWriter(&job->Writer, original);
+
+    job->Prefix = EmptyString;
+    if (prefix.Length > 0)
+        AppendStringView(&job->Prefix, prefix);
+
+    job->Rows = (StringView*)MemoryAllocate(Max(count, 1) * sizeof(StringView));
+    job->RowCount = count;
+    job->TotalBytes = (count > 0) ? count - 1 : 0;
+    for (usize index = 0; index < count; index += 1)
+    {
+        job->Rows[index] = ToStringView(&rows[index]);
+        job->TotalBytes += rows[index].Length;
+    }
+
+    IndexSavedRows(job);
+    InitializeSaveCopies(&job->Copies);
+    job->Lock = CreateThreadLock();
+    atomic_init(&job->WrittenBytes, 0);
+    atomic_init(&job->Finished, false);
+
+    job->Thread = StartBackgroundThread(RunSaveJob, job);
+    return job;
+}
+
+SaveJob* StartSave(StringView filepath, FileDurability durability, StringView prefix, String* rows, usize count)
+{
+    return StartSaveJob(filepath, durability, EmptyStringView, prefix, rows, count);
+}
+
+SaveJob* StartPrivateSave(StringView filepath, FileDurability durability, StringView original, StringView prefix, String* rows, usize count)
+{
+    return StartSaveJob(filepath, durability, original, prefix, rows, count);
+}
+
+void PreserveSavedRow(SaveJob* job, String* row)
+{
+    if (job == NULL || row->Length == 0 || atomic_load(&job->Finished))
+        return;
+
+    usize index = FindSavedRow(job, row->Content);
+    if (index == job->RowCount)
+        return;
+
+    usize length = job->Rows[index].Length;
+    char* copy = (char*)MemoryAllocate(length);
+    MemoryCopy(copy, row->Content, length);
+    AddToSaveCopies(&job->Copies, copy);
+
+    AcquireThreadLock(job->Lock);
+    job->Rows[index].Content = copy;
+    ReleaseThreadLock(job->Lock);
+}
+
+bool IsSaveFinished(SaveJob* job)
+{
+    return atomic_load(&job->Finished);
+}
+
+bool WaitForSave(SaveJob* job, u64 timeout)
+{
+    u64 deadline = GetMonotonicTime() + timeout;
+    while (!IsSaveFinished(job) && GetMonotonicTime() < deadline)
+        SleepFor(100000);
+
+    return IsSaveFinished(job);
+}
+
+usize GetSaveProgress(SaveJob* job)
+{
+    usize written = atomic_load(&job->WrittenBytes);
+    return (job->TotalBytes == 0) ? 100 : (usize)((u64)written * 100 / job->TotalBytes);
+}
+
+bool FinishSave(SaveJob* job)
+{
+    JoinBackgroundThread(job->Thread);
+    bool saved = !job->Writer.Failed;
+
+    for (usize index = 0; index < job->Copies.Count; index += 1)
+        MemoryFree(job->Copies.Values[index]);
+
+    FinalizeSaveCopies(&job->Copies);
+    FinalizeString(&job->Prefix);
+    DestroyThreadLock(job->Lock);
+    MemoryFree(job->Slots);
+    MemoryFree(job->Rows);
+    MemoryFree(job);
+    return saved;
+}
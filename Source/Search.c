@@ -0,0 +1,93 @@
+#include <Search.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+bool VerifySubstring(const char* candidate, StringView needle)
+{
+    return needle.Length <= 2 || MemoryEquals(candidate + 1, needle.Content + 1, needle.Length - 2);
+}
+
+isize FindSubstring(StringView haystack, StringView needle)
+{
+    if (needle.Length == 0)
+        return 0;
+
+    if (needle.Length > haystack.Length)
+        return -1;
+
+    usize last = needle.Length - 1;
+    usize limit = haystack.Length - last;
+    usize index = 0;
+
+#if defined(__SSE2__)
+    __m128i firstBytes = _mm_set1_epi8(needle.Content[0]);
+    __m128i lastBytes = _mm_set1_epi8(needle.Content[last]);
+    for (; index + 16 <= limit; index += 16)
+    {
+        __m128i firstBlock = _mm_loadu_si128((const __m128i*)(haystack.Content + index));
+        __m128i lastBlock = _mm_loadu_si128((const __m128i*)(haystack.Content + index + last));
+        __m128i matches = _mm_and_si128(_mm_cmpeq_epi8(firstBlock, firstBytes), _mm_cmpeq_epi8(lastBlock, lastBytes));
+
+        u32 mask = (u32)_mm_movemask_epi8(matches);
+        while (mask != 0)
+        {
+            usize candidate = index + (usize)__builtin_ctz(mask);
+            if (VerifySubstring(haystack.Content + candidate, needle))
+                return (isize)candidate;
+
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t firstBytes = vdupq_n_u8((u8)needle.Content[0]);
+    uint8x16_t lastBytes = vdupq_n_u8((u8)needle.Content[last]);
+    for (; index + 16 <= limit; index += 16)
+    {
+        uint8x16_t firstBlock = vld1q_u8((const u8*)(haystack.Content + index));
+        uint8x16_t lastBlock = vld1q_u8((const u8*)(haystack.Content + index + last));
+        uint8x16_t matches = vandq_u8(vceqq_u8(firstBlock, firstBytes), vceqq_u8(lastBlock, lastBytes));
+
+        u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+        while (mask != 0)
+        {
+            usize bit = (usize)__builtin_ctzll(mask);
+            usize candidate = index + bit / 4;
+            if (VerifySubstring(haystack.Content + candidate, needle))
+                return (isize)candidate;
+
+            mask &= ~((u64)0xF << (bit & ~(usize)3));
+        }
+    }
+#endif
+
+    for (; index < limit; index += 1)
+    {
+        if (haystack.Content[index] == needle.Content[0] && haystack.Content[index + last] == needle.Content[last]
+            && VerifySubstring(haystack.Content + index, needle))
+            return (isize)index;
+    }
+
+    return -1;
+}
+
+usize CountSubstrings(StringView haystack, StringView needle)
+{
+    if (needle.Length == 0)
+        return 0;
+
+    usize count = 0;
+    while (true)
+    {
+        isize found = FindSubstring(haystack, needle);
+        if (found < 0)
+            return count;
+
+        count += 1;
+        haystack.Content += (usize)found + needle.Length;
+        haystack.Length -= (usize)found + needle.Length;
+    }
+}
@@ -0,0 +1,363 @@
+#include <Syntax.h>
+
+ImplementList(SyntaxRuns, SyntaxRun)
+
+void InitializeSyntaxCache(SyntaxCache* cache)
+{
+    cache->Enabled = false;
+    cache->States = NULL;
+    cache->Capacity = 0;
+    cache->Known = 0;
+    cache->Valid = 0;
+    cache->DirtyRow = 0;
+    InitializeSyntaxRuns(&cache->Runs);
+}
+
+void FinalizeSyntaxCache(SyntaxCache* cache)
+{
+    FinalizeSyntaxRuns(&cache->Runs);
+    MemoryFree(cache->States);
+}
+
+bool IsSyntaxPath(StringView path)
+{
+    static const StringView extensions[] = {
+        AsStringView(".c"),  AsStringView(".h"),   AsStringView(".cc"),  AsStringView(".cpp"),
+        AsStringView(".cxx"), AsStringView(".hh"), AsStringView(".hpp"), AsStringView(".hxx"),
+    };
+
+    for (usize index = 0; index < sizeof(extensions) / sizeof(extensions[0]); index += 1)
+    {
+        StringView extension = extensions[index];
+        if (path.Length > extension.Length
+            && StringViewEquals((StringView){.Length = extension.Length, .Content = path.Content + path.Length - extension.Length}, extension))
+            return true;
+    }
+
+    return false;
+}
+
+Color GetSyntaxColor(SyntaxStyle style)
+{
+    switch (style)
+    {
+        case SYNTAX_STYLE_NORMAL:
+            return COLOR_RESET;
+        case SYNTAX_STYLE_KEYWORD:
+            return COLOR_MAGENTA;
+        case SYNTAX_STYLE_TYPE:
+            return COLOR_CYAN;
+        case SYNTAX_STYLE_NUMBER:
+            return COLOR_YELLOW;
+        case SYNTAX_STYLE_STRING:
+            return COLOR_GREEN;
+        case SYNTAX_STYLE_COMMENT:
+            return COLOR_BRIGHT_BLACK;
+        case SYNTAX_STYLE_PREPROCESSOR:
+            return COLOR_BLUE;
+    }
+
+    return COLOR_RESET;
+}
+
+bool IsIdentifierStart(char character)
+{
+    return IsUppercase(character) || IsLowercase(character) || character == '_';
+}
+
+bool IsIdentifierPart(char character)
+{
+    return IsIdentifierStart(character) || IsDigit(character);
+}
+
+bool IsSpace(char character)
+{
+    return character == ' ' || character == '\t';
+}
+
+bool ContainsWord(const StringView* words, usize count, StringView word)
+{
+    for (usize index = 0; index < count; index += 1)
+    {
+        if (StringViewEquals(words[index], word))
+            return true;
+    }
+
+    return false;
+}
+
+SyntaxStyle ClassifyIdentifier(StringView word)
+{
+    // clang-format off
+    static const StringView keywords[] = {
+        AsStringView("break"), AsStringView("case"), AsStringView("const"), AsStringView("continue"),
+        AsStringView("default"), AsStringView("do"), AsStringView("else"), AsStringView("enum"),
+        AsStringView("extern"), AsStringView("false"), AsStringView("for"), AsStringView("goto"),
+        AsStringView("if"), AsStringView("inline"), AsStringView("register"), AsStringView("restrict"),
+        AsStringView("return"), AsStringView("sizeof"), AsStringView("static"), AsStringView("struct"),
+        AsStringView("switch"), AsStringView("true"), AsStringView("typedef"), AsStringView("union"),
+        AsStringView("volatile"), AsStringView("while"), AsStringView("NULL"), AsStringView("_Alignas"),
+        AsStringView("_Alignof"), AsStringView("_Atomic"), AsStringView("_Generic"), AsStringView("_Noreturn"),
+        AsStringView("_Static_assert"), AsStringView("_Thread_local"),
+    };
+    static const StringView types[] = {
+        AsStringView("void"), AsStringView("char"), AsStringView("short"), AsStringView("int"),
+        AsStringView("long"), AsStringView("float"), AsStringView("double"), AsStringView("signed"),
+        AsStringView("unsigned"), AsStringView("bool"), AsStringView("_Bool"), AsStringView("u8"),
+        AsStringView("u16"), AsStringView("u32"), AsStringView("u64"), AsStringView("i8"),
+        AsStringView("i16"), AsStringView("i32"), AsStringView("i64"), AsStringView("usize"),
+        AsStringView("isize"), AsStringView("size_t"),
+    };
+    // clang-format on
+
+    if (ContainsWord(keywords, sizeof(keywords) / sizeof(keywords[0]), word))
+        return SYNTAX_STYLE_KEYWORD;
+
+    if (ContainsWord(types, sizeof(types) / sizeof(types[0]), word))
+        return SYNTAX_STYLE_TYPE;
+
+    return SYNTAX_STYLE_NORMAL;
+}
+
+void AddSyntaxRun(SyntaxRuns* runs, usize start, usize end, SyntaxStyle style)
+{
+    if (runs == NULL || start == end)
+        return;
+
+    if (runs->Count > 0)
+    {
+        SyntaxRun* last = &runs->Values[runs->Count - 1];
+        if (last->Style == style && last->End == start)
+        {
+            last->End = end;
+            return;
+        }
+    }
+
+    SyntaxRun run = {.Start = start, .End = end, .Style = style};
+    AddToSyntaxRuns(runs, run);
+}
+
+void AddSyntaxSpace(SyntaxRuns* runs, usize start, usize end)
+{
+    if (runs == NULL || start == end)
+        return;
+
+    if (runs->Count > 0 && runs->Values[runs->Count - 1].End == start)
+        runs->Values[runs->Count - 1].End = end;
+    else
+        AddSyntaxRun(runs, start, end, SYNTAX_STYLE_NORMAL);
+}
+
+usize SkipBlockComment(StringView line, usize index, bool* closed)
+{
+    for (; index + 1 < line.Length; index += 1)
+    {
+        if (line.Content[index] == '*' && line.Content[index + 1] == '/')
+        {
+            *closed = true;
+            return index + 2;
+        }
+    }
+
+    *closed = false;
+    return line.Length;
+}
+
+usize SkipQuoted(StringView line, usize index)
+{
+    char quote = line.Content[index];
+    for (index += 1; index < line.Length; index += 1)
+    {
+        if (line.Content[index] == '\\')
+            index += 1;
+        else if (line.Content[index] == quote)
+            return index + 1;
+    }
+
+    return line.Length;
+}
+
+SyntaxState LexSyntaxLine(StringView line, SyntaxState state, SyntaxRuns* runs)
+{
+    if (runs != NULL)
+        ClearSyntaxRuns(runs);
+
+    usize index = 0;
+    if (state == SYNTAX_STATE_COMMENT)
+    {
+        bool closed;
+        index = SkipBlockComment(line, 0, &closed);
+        AddSyntaxRun(runs, 0, index, SYNTAX_STYLE_COMMENT);
+        if (!closed)
+            return SYNTAX_STATE_COMMENT;
+    }
+
+    usize first = index;
+    while (first < line.Length && IsSpace(line.Content[first]))
+        first += 1;
+
+    bool directive = state == SYNTAX_STATE_PREPROCESSOR || (first < line.Length && line.Content[first] == '#');
+
+    SyntaxStyle plain = directive ? SYNTAX_STYLE_PREPROCESSOR : SYNTAX_STYLE_NORMAL;
+    while (index < line.Length)
+    {
+        char character = line.Content[index];
+        usize start = index;
+        if (IsSpace(character))
+        {
+            while (index < line.Length && IsSpace(line.Content[index]))
+                index += 1;
+
+            AddSyntaxSpace(runs, start, index);
+        }
+        else if (character == '/' && index + 1 < line.Length && line.Content[index + 1] == '/')
+        {
+            AddSyntaxRun(runs, start, line.Length, SYNTAX_STYLE_COMMENT);
+            return SYNTAX_STATE_NORMAL;
+        }
+        else if (character == '/' && index + 1 < line.Length && line.Content[index + 1] == '*')
+        {
+            bool closed;
+            index = SkipBlockComment(line, index + 2, &closed);
+            AddSyntaxRun(runs, start, index, SYNTAX_STYLE_COMMENT);
+            if (!closed)
+                return SYNTAX_STATE_COMMENT;
+        }
+        else if (character == '"' || character == '\'')
+        {
+            index = SkipQuoted(line, index);
+            AddSyntaxRun(runs, start, index, SYNTAX_STYLE_STRING);
+        }
+        else if (IsDigit(character) || (character == '.' && index + 1 < line.Length && IsDigit(line.Content[index + 1])))
+        {
+            while (index < line.Length && (IsIdentifierPart(line.Content[index]) || line.Content[index] == '.'))
+                index += 1;
+
+            AddSyntaxRun(runs, start, index, SYNTAX_STYLE_NUMBER);
+        }
+        else if (IsIdentifierStart(character))
+        {
+            while (index < line.Length && IsIdentifierPart(line.Content[index]))
+                index += 1;
+
+            SyntaxStyle style = plain;
+            if (runs != NULL && !directive)
+                style = ClassifyIdentifier((StringView){.Length = index - start, .Content = line.Content + start});
+
+            AddSyntaxRun(runs, start, index, style);
+        }
+        else
+        {
+            index += 1;
+            AddSyntaxRun(runs, start, index, plain);
+        }
+    }
+
+    if (directive && line.Length > 0 && line.Content[line.Length - 1] == '\\')
+        return SYNTAX_STATE_PREPROCESSOR;
+
+    return SYNTAX_STATE_NORMAL;
+}
+
+void ReserveSyntaxStates(SyntaxCache* cache, usize count)
+{
+    if (count <= cache->Capacity)
+        return;
+
+    usize capacity = Max(count, cache->Capacity * 2);
+    u8* states = (u8*)MemoryAllocate(capacity);
+    if (cache->States != NULL)
+    {
+        MemoryCopy(states, cache->States, cache->Known);
+        MemoryFree(cache->States);
+    }
+
+    cache->States = states;
+    cache->Capacity = capacity;
+}
+
+void MarkSyntaxDirty(SyntaxCache* cache, usize first, usize last)
+{
+    bool settled = cache->Valid > cache->DirtyRow;
+    cache->DirtyRow = settled ? last : Max(cache->DirtyRow, last);
+    cache->Valid = Min(cache->Valid, first);
+}
+
+void InvalidateSyntaxRow(SyntaxCache* cache, usize row)
+{
+    if (row < cache->Known)
+        MarkSyntaxDirty(cache, row, row);
+}
+
+void InsertSyntaxRow(SyntaxCache* cache, usize row)
+{
+    if (row == 0 || row - 1 >= cache->Known)
+        return;
+
+    ReserveSyntaxStates(cache, cache->Known + 1);
+    MemoryCopy(cache->States + row, cache->States + row - 1, cache->Known - (row - 1));
+    cache->Known += 1;
+
+    if (cache->DirtyRow >= row)
+        cache->DirtyRow += 1;
+
+    if (cache->Valid >= row)
+        cache->Valid += 1;
+
+    MarkSyntaxDirty(cache, row - 1, row);
+}
+
+void RemoveSyntaxRow(SyntaxCache* cache, usize row)
+{
+    if (row == 0 || row - 1 >= cache->Known)
+        return;
+
+    if (row < cache->Known)
+    {
+        MemoryCopy(cache->States + row - 1, cache->States + row, cache->Known - row);
+        cache->Known -= 1;
+    }
+
+    if (cache->DirtyRow >= row)
+        cache->DirtyRow -= 1;
+
+    if (cache->Valid > row)
+        cache->Valid -= 1;
+
+    MarkSyntaxDirty(cache, row - 1, row - 1);
+}
+
+void InvalidateSyntaxFrom(SyntaxCache* cache, usize row)
+{
+    cache->Known = Min(cache->Known, row);
+    cache->Valid = Min(cache->Valid, row);
+}
+
+void PrepareSyntax(SyntaxCache* cache, String* rows, usize rowCount, usize endRow)
+{
+    cache->Known = Min(cache->Known, rowCount);
+    cache->Valid = Min(cache->Valid, cache->Known);
+    ReserveSyntaxStates(cache, rowCount);
+
+    endRow = Min(endRow, rowCount);
+    while (cache->Valid < endRow)
+    {
+        usize row = cache->Valid;
+        SyntaxState state = GetSyntaxStartState(cache, row);
+        SyntaxState end = LexSyntaxLine(ToStringView(&rows[row]), state, NULL);
+
+        bool converged = row < cache->Known && row >= cache->DirtyRow && cache->States[row] == (u8)end;
+        cache->States[row] = (u8)end;
+        cache->Valid = converged ? cache->Known : row + 1;
+        cache->Known = Max(cache->Known, cache->Valid);
+
+        if (cache->Valid < cache->Known)
+            cache->DirtyRow = Max(cache->DirtyRow, cache->Valid);
+    }
+}
+
+SyntaxState GetSyntaxStartState(SyntaxCache* cache, usize row)
+{
+    return (row > 0) ? (SyntaxState)cache->States[row - 1] : SYNTAX_STATE_NORMAL;
+}
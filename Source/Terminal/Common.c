@@ -0,0 +1,90 @@
+#include <Terminal.h>
+#include <Utility.h>
+
+void EncodeCommandStream(CommandStream* stream, String* out)
+{
+    for (usize index = 0; index < stream->Count; index += 1)
+    {
+        Command* command = &stream->Values[index];
+        switch (command->Kind)
+        {
+            case COMMAND_NONE:
+                break;
+            case COMMAND_PRINT:
+                AppendStringView(out, command->Print.Text);
+                break;
+            case COMMAND_PRINT_ROW:
+                AppendStr(out, "\x1B[");
+                AppendUInt(out, command->PrintRow.Y);
+                AppendStr(out, ";1H");
+                AppendStringView(out, command->PrintRow.Text);
+                AppendStr(out, "\x1B[0K");
+                break;
+            case COMMAND_MOVE_CURSOR:
+                AppendStr(out, "\x1B[");
+                AppendUInt(out, command->MoveCursor.Y);
+                AppendChar(out, ';');
+                AppendUInt(out, command->MoveCursor.X);
+                AppendChar(out, 'H');
+                break;
+            case COMMAND_UPDATE_CURSOR_VISIBILITY:
+                AppendStr(out, "\x1B[?25");
+                AppendChar(out, command->UpdateCursorVisibility.Visible ? 'h' : 'l');
+                break;
+            case COMMAND_CLEAR_SCREEN:
+                AppendStr(out, "\x1B[");
+                AppendUInt(out, (u64)command->ClearScreen.Mode);
+                AppendChar(out, 'J');
+                break;
+            case COMMAND_CLEAR_LINE:
+                AppendStr(out, "\x1B[");
+                AppendUInt(out, (u64)command->ClearLine.Mode);
+                AppendChar(out, 'K');
+                break;
+            case COMMAND_SET_FOREGROUND:
+                switch (command->SetForeground.Value.Kind)
+                {
+                    case COLOR_KIND_RESET:
+                        AppendStr(out, "\x1B[39m");
+                        break;
+                    case COLOR_KIND_RGB:
+                        AppendStr(out, "\x1B[38;2;");
+                        AppendUInt(out, command->SetForeground.Value.Red);
+                        AppendChar(out, ';');
+                        AppendUInt(out, command->SetForeground.Value.Green);
+                        AppendChar(out, ';');
+                        AppendUInt(out, command->SetForeground.Value.Blue);
+                        AppendChar(out, 'm');
+                        break;
+                    case COLOR_KIND_ANSI:
+                        AppendStr(out, "\x1B[38;5;");
+                        AppendUInt(out, command->SetForeground.Value.AnsiValue);
+                        AppendChar(out, 'm');
+                        break;
+                }
+                break;
+            case COMMAND_SET_BACKGROUND:
+                switch (command->SetBackground.Value.Kind)
+                {
+                    case COLOR_KIND_RESET:
+                        AppendStr(out, "\x1B[49m");
+                        break;
+                    case COLOR_KIND_RGB:
+                        AppendStr(out, "\x1B[48;2;");
+                        AppendUInt(out, command->SetBackground.Value.Red);
+                        AppendChar(out, ';');
+                        AppendUInt(out, command->SetBackground.Value.Green);
+                        AppendChar(out, ';');
+                        AppendUInt(out, command->SetBackground.Value.Blue);
+                        AppendChar(out, 'm');
+                        break;
+                    case COLOR_KIND_ANSI:
+                        AppendStr(out, "\x1B[48;5;");
+                        AppendUInt(out, command->SetBackground.Value.AnsiValue);
+                        AppendChar(out, 'm');
+                        break;
+                }
+                break;
+        }
+    }
+}
\ No newline at end of file
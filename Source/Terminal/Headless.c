@@ -0,0 +1,122 @@
+#include <Terminal.h>
+
+#if defined(LIE_TERMINAL_HEADLESS)
+
+#include <Utility.h>
+#include <Queue.h>
+#include <Profiler.h>
+
+DeclareQueue(ScriptedEvents, Event)
+ImplementQueue(ScriptedEvents, Event)
+
+struct Terminal
+{
+    u16 Width;
+    u16 Height;
+
+    ScriptedEvents Events;
+    String Out;
+
+    TerminalStatistics Statistics;
+};
+
+Terminal* CreateTerminal()
+{
+    return CreateHeadlessTerminal(80, 24);
+}
+
+Terminal* CreateHeadlessTerminal(u16 width, u16 height)
+{
+    Terminal* terminal = (Terminal*)MemoryAllocate(sizeof(Terminal));
+    terminal->Width = width;
+    terminal->Height = height;
+    InitializeScriptedEvents(&terminal->Events);
+    InitializeString(&terminal->Out);
+    MemoryClear(&terminal->Statistics, sizeof(TerminalStatistics));
+    return terminal;
+}
+
+void DestroyTerminal(Terminal* terminal)
+{
+    FinalizeString(&terminal->Out);
+    FinalizeScriptedEvents(&terminal->Events);
+    MemoryFree(terminal);
+}
+
+void PushTerminalEvent(Terminal* terminal, Event* event)
+{
+    EnqueueScriptedEvents(&terminal->Events, *event);
+}
+
+StringView GetTerminalFrame(Terminal* terminal)
+{
+    return ToStringView(&terminal->Out);
+}
+
+bool IsTerminalInteractive(Terminal* terminal)
+{
+    return true;
+}
+
+void EnableRawMode(Terminal* terminal)
+{
+}
+
+void DisableRawMode(Terminal* terminal)
+{
+}
+
+void EnterAlternateScreen(Terminal* terminal)
+{
+}
+
+void LeaveAlternateScreen(Terminal* terminal)
+{
+}
+
+bool GetTerminalSize(Terminal* terminal, u16* width, u16* height)
+{
+    *width = terminal->Width;
+    *height = terminal->Height;
+    return true;
+}
+
+bool GetCursorPosition(Terminal* terminal, u16* x, u16* y)
+{
+    *x = 1;
+    *y = 1;
+    return true;
+}
+
+bool ReadEvent(Terminal* terminal, Event* event)
+{
+    return DequeueScriptedEvents(&terminal->Events, event);
+}
+
+usize GetPendingEventCount(Terminal* terminal)
+{
+    return terminal->Events.Count;
+}
+
+void ProcessCommandStream(Terminal* terminal, CommandStream* stream)
+{
+    terminal->Out.Length = 0;
+
+    ProfileScope encodeScope = BeginProfileScope("EncodeCommands");
+    u64 encodeStart = GetMonotonicTime();
+    EncodeCommandStream(stream, &terminal->Out);
+    u64 encodeTime = GetMonotonicTime() - encodeStart;
+    EndProfileScope(encodeScope);
+
+    terminal->Statistics.Frames += 1;
+    terminal->Statistics.EncodeNanoseconds += encodeTime;
+    terminal->Statistics.BytesWritten += terminal->Out.Length;
+    terminal->Statistics.LastFrameBytes = terminal->Out.Length;
+}
+
+void GetTerminalStatistics(Terminal* terminal, TerminalStatistics* statistics)
+{
+    *statistics = terminal->Statistics;
+}
+
+#endif
\ No newline at end of file
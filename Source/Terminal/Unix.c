@@ -1,14 +1,44 @@
 #include <Terminal.h>
 
-#if defined(LIE_PLATFORM_LINUX) || defined(LIE_PLATFORM_MACOS)
+#if (defined(LIE_PLATFORM_LINUX) || defined(LIE_PLATFORM_MACOS)) && !defined(LIE_TERMINAL_HEADLESS)
 
 #include <Utility.h>
+#include <Unicode.h>
 #include <IO.h>
+#include <Queue.h>
+#include <Profiler.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 
+#define TERMINAL_INPUT_CAPACITY       1024
+#define TERMINAL_INPUT_TIMEOUT        100000000
+#define TERMINAL_LOCAL_WRITE_TIME     2000000
+#define TERMINAL_LOCAL_PENDING_BYTES  4096
+#define TERMINAL_MIN_FRAME_INTERVAL   16666666
+#define TERMINAL_MAX_FRAME_INTERVAL   250000000
+
+DeclareRingQueue(InputEvents, Event)
+ImplementRingQueue(InputEvents, Event)
+
+void MakeTerminalDeadline(struct timespec* deadline, u64 timeout);
+bool DecodeEvent(Terminal* terminal, Event* event);
+bool DecodeCharacterEvent(Terminal* terminal, Event* event);
+void* RunTerminalReader(void* argument);
+bool PauseTerminalReader(Terminal* terminal);
+void ResumeTerminalReader(Terminal* terminal, bool reading);
+bool WriteTerminalOutput(Terminal* terminal, const char* content, usize length);
+void FlushTerminalOutput(Terminal* terminal);
+bool WriteTerminalControl(Terminal* terminal, StringView control);
+void AdaptFrameInterval(Terminal* terminal, u64 writeTime, u64 pendingBytes);
+void* RunTerminalWriter(void* argument);
+
 KeyModifier GetKeyModifiers(u8 value);
 bool ReadKeyModifiers(Terminal* terminal, KeyModifier* modifiers, usize index);
 bool HandleSS3Codes(Terminal* terminal, Event* event, KeyModifier modifiers);
@@ -24,21 +54,88 @@ struct Terminal
 
     char In[32];
     String Out;
+
+    pthread_t Reader;
+    pthread_mutex_t InputLock;
+    pthread_cond_t InputReady;
+    InputEvents Input;
+    _Atomic bool Reading;
+
+    i32 Output;
+    bool OwnsOutput;
+
+    pthread_t Writer;
+    pthread_mutex_t Lock;
+    pthread_cond_t FrameReady;
+    pthread_cond_t FrameWritten;
+    String Pending;
+    String Writing;
+    bool Busy;
+    bool Running;
+    u64 SmoothedWriteTime;
+
+    TerminalStatistics Statistics;
 };
 
 Terminal* CreateTerminal()
 {
     Terminal* terminal = (Terminal*)MemoryAllocate(sizeof(Terminal));
     InitializeString(&terminal->Out);
+    InitializeString(&terminal->Pending);
+    InitializeString(&terminal->Writing);
+    MemoryClear(&terminal->Statistics, sizeof(TerminalStatistics));
+
+    InitializeInputEvents(&terminal->Input, TERMINAL_INPUT_CAPACITY);
+    atomic_init(&terminal->Reading, false);
+    pthread_mutex_init(&terminal->InputLock, NULL);
+    pthread_cond_init(&terminal->InputReady, NULL);
+
+    const char* device = isatty(STDOUT_FILENO) ? ttyname(STDOUT_FILENO) : NULL;
+    terminal->Output = (device != NULL) ? open(device, O_WRONLY | O_NONBLOCK | O_NOCTTY | O_CLOEXEC) : -1;
+    terminal->OwnsOutput = terminal->Output >= 0;
+    if (!terminal->OwnsOutput)
+        terminal->Output = STDOUT_FILENO;
+
+    terminal->Busy = false;
+    terminal->Running = true;
+    terminal->SmoothedWriteTime = 0;
+    pthread_mutex_init(&terminal->Lock, NULL);
+    pthread_cond_init(&terminal->FrameReady, NULL);
+    pthread_cond_init(&terminal->FrameWritten, NULL);
+    pthread_create(&terminal->Writer, NULL, RunTerminalWriter, terminal);
     return terminal;
 }
 
 void DestroyTerminal(Terminal* terminal)
 {
+    pthread_mutex_lock(&terminal->Lock);
+    terminal->Running = false;
+    pthread_cond_signal(&terminal->FrameReady);
+    pthread_mutex_unlock(&terminal->Lock);
+    pthread_join(terminal->Writer, NULL);
+
+    pthread_cond_destroy(&terminal->FrameWritten);
+    pthread_cond_destroy(&terminal->FrameReady);
+    pthread_mutex_destroy(&terminal->Lock);
+
+    if (terminal->OwnsOutput)
+        close(terminal->Output);
+
+    pthread_cond_destroy(&terminal->InputReady);
+    pthread_mutex_destroy(&terminal->InputLock);
+    FinalizeInputEvents(&terminal->Input);
+
+    FinalizeString(&terminal->Writing);
+    FinalizeString(&terminal->Pending);
     FinalizeString(&terminal->Out);
     MemoryFree(terminal);
 }
 
+bool IsTerminalInteractive(Terminal* terminal)
+{
+    return IsTTY();
+}
+
 void EnableRawMode(Terminal* terminal)
 {
     tcgetattr(STDIN_FILENO, &terminal->OriginalTermios);
@@ -50,23 +147,25 @@ void EnableRawMode(Terminal* terminal)
     raw.c_cc[VMIN] = 0;
     raw.c_cc[VTIME] = 1;
     tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+    ResumeTerminalReader(terminal, true);
 }
 
 void DisableRawMode(Terminal* terminal)
 {
+    PauseTerminalReader(terminal);
     tcsetattr(STDIN_FILENO, TCSAFLUSH, &terminal->OriginalTermios);
 }
 
 void EnterAlternateScreen(Terminal* terminal)
 {
     static const StringView enterCode = AsStringView("\x1B[?1049h");
-    WriteStdOut(enterCode.Content, enterCode.Length);
+    WriteTerminalControl(terminal, enterCode);
 }
 
 void LeaveAlternateScreen(Terminal* terminal)
 {
     static const StringView leaveCode = AsStringView("\x1B[?1049l");
-    WriteStdOut(leaveCode.Content, leaveCode.Length);
+    WriteTerminalControl(terminal, leaveCode);
 }
 
 bool GetTerminalSize(Terminal* terminal, u16* width, u16* height)
@@ -83,15 +182,21 @@ bool GetTerminalSize(Terminal* terminal, u16* width, u16* height)
     static const StringView moveCursor = AsStringView("\x1B[6n");
     static const StringView restoreCursor = AsStringView("\x1B[u");
 
-    return WriteStdOut(saveCursor.Content, saveCursor.Length) && WriteStdOut(moveCursor.Content, moveCursor.Length)
-        && GetCursorPosition(terminal, width, height) && WriteStdOut(restoreCursor.Content, restoreCursor.Length);
+    return WriteTerminalControl(terminal, saveCursor) && WriteTerminalControl(terminal, moveCursor)
+        && GetCursorPosition(terminal, width, height) && WriteTerminalControl(terminal, restoreCursor);
 }
 
 bool GetCursorPosition(Terminal* terminal, u16* x, u16* y)
 {
     static const StringView queryCursor = AsStringView("\x1B[6n");
-    if (!WriteStdOut(queryCursor.Content, queryCursor.Length))
+
+    // The reply arrives on the standard input, so the reader must not consume it as keys.
+    bool reading = PauseTerminalReader(terminal);
+    if (!WriteTerminalControl(terminal, queryCursor))
+    {
+        ResumeTerminalReader(terminal, reading);
         return false;
+    }
 
     usize index = 0;
     usize semicolon = 0;
@@ -104,6 +209,8 @@ bool GetCursorPosition(Terminal* terminal, u16* x, u16* y)
         index += 1;
     }
 
+    ResumeTerminalReader(terminal, reading);
+
     if (terminal->In[0] != '\x1B' || terminal->In[1] != '[')
         return false;
 
@@ -114,6 +221,75 @@ bool GetCursorPosition(Terminal* terminal, u16* x, u16* y)
 }
 
 bool ReadEvent(Terminal* terminal, Event* event)
+{
+    if (PopInputEvents(&terminal->Input, event))
+        return true;
+
+    struct timespec deadline;
+    MakeTerminalDeadline(&deadline, TERMINAL_INPUT_TIMEOUT);
+
+    pthread_mutex_lock(&terminal->InputLock);
+    if (CountInputEvents(&terminal->Input) == 0)
+        pthread_cond_timedwait(&terminal->InputReady, &terminal->InputLock, &deadline);
+    pthread_mutex_unlock(&terminal->InputLock);
+
+    return PopInputEvents(&terminal->Input, event);
+}
+
+void MakeTerminalDeadline(struct timespec* deadline, u64 timeout)
+{
+    clock_gettime(CLOCK_REALTIME, deadline);
+    u64 nanoseconds = (u64)deadline->tv_nsec + timeout;
+    deadline->tv_sec += (time_t)(nanoseconds / 1000000000);
+    deadline->tv_nsec = (long)(nanoseconds % 1000000000);
+}
+
+usize GetPendingEventCount(Terminal* terminal)
+{
+    return CountInputEvents(&terminal->Input);
+}
+
+void* RunTerminalReader(void* argument)
+{
+    Terminal* terminal = (Terminal*)argument;
+
+    Event event;
+    while (atomic_load(&terminal->Reading))
+    {
+        if (!DecodeEvent(terminal, &event))
+            continue;
+
+        event.Timestamp = GetMonotonicTime();
+        while (!PushInputEvents(&terminal->Input, event) && atomic_load(&terminal->Reading))
+            SleepFor(1000000);
+
+        pthread_mutex_lock(&terminal->InputLock);
+        pthread_cond_signal(&terminal->InputReady);
+        pthread_mutex_unlock(&terminal->InputLock);
+    }
+
+    return NULL;
+}
+
+bool PauseTerminalReader(Terminal* terminal)
+{
+    bool reading = atomic_exchange(&terminal->Reading, false);
+    if (reading)
+        pthread_join(terminal->Reader, NULL);
+
+    return reading;
+}
+
+void ResumeTerminalReader(Terminal* terminal, bool reading)
+{
+    if (!reading)
+        return;
+
+    atomic_store(&terminal->Reading, true);
+    pthread_create(&terminal->Reader, NULL, RunTerminalReader, terminal);
+}
+
+bool DecodeEvent(Terminal* terminal, Event* event)
 {
     if (!ReadStdIn(&terminal->In[0], 1))
         return false;
@@ -139,6 +315,9 @@ bool ReadEvent(Terminal* terminal, Event* event)
         return true;
     }
 
+    if ((u8)terminal->In[0] >= 0x80)
+        return DecodeCharacterEvent(terminal, event);
+
     KeyModifier modifiers = KEY_MODIFIER_NONE;
 
     if ('\x01' <= terminal->In[0] && terminal->In[0] <= '\x1F')
@@ -151,92 +330,163 @@ bool ReadEvent(Terminal* terminal, Event* event)
         modifiers = KEY_MODIFIER_SHIFT;
     }
 
-    MakeKeyEvent(event, KEY_CODE_CHARACTER, modifiers, terminal->In[0]);
+    MakeKeyEvent(event, KEY_CODE_CHARACTER, modifiers, (u8)terminal->In[0]);
     return true;
 }
 
-void ProcessCommandQueue(Terminal* terminal, CommandQueue* queue)
+bool DecodeCharacterEvent(Terminal* terminal, Event* event)
 {
-    Command command;
-    while (DequeueCommandQueue(queue, &command))
+    usize length = GetUtf8SequenceLength(terminal->In[0]);
+    usize index = 1;
+    while (index < length && ReadStdIn(&terminal->In[index], 1))
+        index += 1;
+
+    u32 codepoint;
+    if (DecodeUtf8(terminal->In, index, &codepoint) != length)
+        codepoint = UNICODE_REPLACEMENT_CHARACTER;
+
+    MakeKeyEvent(event, KEY_CODE_CHARACTER, KEY_MODIFIER_NONE, codepoint);
+    return true;
+}
+
+void ProcessCommandStream(Terminal* terminal, CommandStream* stream)
+{
+    ProfileScope encodeScope = BeginProfileScope("EncodeCommands");
+    u64 encodeStart = GetMonotonicTime();
+    EncodeCommandStream(stream, &terminal->Out);
+    u64 encodeTime = GetMonotonicTime() - encodeStart;
+    EndProfileScope(encodeScope);
+
+    pthread_mutex_lock(&terminal->Lock);
+    if (terminal->Pending.Length > 0)
+        terminal->Statistics.DroppedFrames += 1;
+
+    String frame = terminal->Pending;
+    terminal->Pending = terminal->Out;
+    terminal->Out = frame;
+
+    terminal->Statistics.Frames += 1;
+    terminal->Statistics.EncodeNanoseconds += encodeTime;
+    terminal->Statistics.LastFrameBytes = terminal->Pending.Length;
+    pthread_cond_signal(&terminal->FrameReady);
+    pthread_mutex_unlock(&terminal->Lock);
+
+    terminal->Out.Length = 0;
+}
+
+void GetTerminalStatistics(Terminal* terminal, TerminalStatistics* statistics)
+{
+    pthread_mutex_lock(&terminal->Lock);
+    *statistics = terminal->Statistics;
+    pthread_mutex_unlock(&terminal->Lock);
+}
+
+bool WriteTerminalOutput(Terminal* terminal, const char* content, usize length)
+{
+    usize writtenBytes = 0;
+    while (writtenBytes < length)
     {
-        switch (command.Kind)
+        isize bytesWritten = write(terminal->Output, content + writtenBytes, length - writtenBytes);
+        if (bytesWritten >= 0)
         {
-            case COMMAND_NONE:
-                break;
-            case COMMAND_PRINT:
-                AppendStringView(&terminal->Out, command.Print.Text);
-                break;
-            case COMMAND_MOVE_CURSOR:
-                AppendStr(&terminal->Out, "\x1B[");
-                AppendUInt(&terminal->Out, command.MoveCursor.Y);
-                AppendChar(&terminal->Out, ';');
-                AppendUInt(&terminal->Out, command.MoveCursor.X);
-                AppendChar(&terminal->Out, 'H');
-                break;
-            case COMMAND_UPDATE_CURSOR_VISIBILITY:
-                AppendStr(&terminal->Out, "\x1B[?25");
-                AppendChar(&terminal->Out, command.UpdateCursorVisibility.Visible ? 'h' : 'l');
-                break;
-            case COMMAND_CLEAR_SCREEN:
-                AppendStr(&terminal->Out, "\x1B[");
-                AppendUInt(&terminal->Out, (u64)command.ClearScreen.Mode);
-                AppendChar(&terminal->Out, 'J');
-                break;
-            case COMMAND_CLEAR_LINE:
-                AppendStr(&terminal->Out, "\x1B[");
-                AppendUInt(&terminal->Out, (u64)command.ClearLine.Mode);
-                AppendChar(&terminal->Out, 'K');
-                break;
-            case COMMAND_SET_FOREGROUND:
-                switch (command.SetForeground.Value.Kind)
-                {
-                    case COLOR_KIND_RESET:
-                        AppendStr(&terminal->Out, "\x1B[39m");
-                        break;
-                    case COLOR_KIND_RGB:
-                        AppendStr(&terminal->Out, "\x1B[38;2;");
-                        AppendUInt(&terminal->Out, command.SetForeground.Value.Red);
-                        AppendChar(&terminal->Out, ';');
-                        AppendUInt(&terminal->Out, command.SetForeground.Value.Green);
-                        AppendChar(&terminal->Out, ';');
-                        AppendUInt(&terminal->Out, command.SetForeground.Value.Blue);
-                        AppendChar(&terminal->Out, 'm');
-                        break;
-                    case COLOR_KIND_ANSI:
-                        AppendStr(&terminal->Out, "\x1B[38;5;");
-                        AppendUInt(&terminal->Out, command.SetForeground.Value.AnsiValue);
-                        AppendChar(&terminal->Out, 'm');
-                        break;
-                }
-                break;
-            case COMMAND_SET_BACKGROUND:
-                switch (command.SetBackground.Value.Kind)
-                {
-                    case COLOR_KIND_RESET:
-                        AppendStr(&terminal->Out, "\x1B[49m");
-                        break;
-                    case COLOR_KIND_RGB:
-                        AppendStr(&terminal->Out, "\x1B[48;2;");
-                        AppendUInt(&terminal->Out, command.SetBackground.Value.Red);
-                        AppendChar(&terminal->Out, ';');
-                        AppendUInt(&terminal->Out, command.SetBackground.Value.Green);
-                        AppendChar(&terminal->Out, ';');
-                        AppendUInt(&terminal->Out, command.SetBackground.Value.Blue);
-                        AppendChar(&terminal->Out, 'm');
-                        break;
-                    case COLOR_KIND_ANSI:
-                        AppendStr(&terminal->Out, "\x1B[48;5;");
-                        AppendUInt(&terminal->Out, command.SetBackground.Value.AnsiValue);
-                        AppendChar(&terminal->Out, 'm');
-                        break;
-                }
-                break;
+            writtenBytes += (usize)bytesWritten;
+            continue;
         }
+
+        if (errno == EINTR)
+            continue;
+
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            return false;
+
+        struct pollfd descriptor = {.fd = terminal->Output, .events = POLLOUT};
+        poll(&descriptor, 1, -1);
     }
 
-    WriteStdOut(terminal->Out.Content, terminal->Out.Length);
-    terminal->Out.Length = 0;
+    return true;
+}
+
+void FlushTerminalOutput(Terminal* terminal)
+{
+    pthread_mutex_lock(&terminal->Lock);
+    while (terminal->Pending.Length > 0 || terminal->Busy)
+        pthread_cond_wait(&terminal->FrameWritten, &terminal->Lock);
+    pthread_mutex_unlock(&terminal->Lock);
+}
+
+bool WriteTerminalControl(Terminal* terminal, StringView control)
+{
+    FlushTerminalOutput(terminal);
+    return WriteTerminalOutput(terminal, control.Content, control.Length);
+}
+
+void AdaptFrameInterval(Terminal* terminal, u64 writeTime, u64 pendingBytes)
+{
+    terminal->SmoothedWriteTime = (terminal->SmoothedWriteTime * 7 + writeTime) / 8;
+
+    terminal->Statistics.LastWriteNanoseconds = writeTime;
+    terminal->Statistics.PendingBytes = pendingBytes;
+
+    if (terminal->SmoothedWriteTime < TERMINAL_LOCAL_WRITE_TIME && pendingBytes < TERMINAL_LOCAL_PENDING_BYTES)
+    {
+        terminal->Statistics.FrameInterval = 0;
+        return;
+    }
+
+    u64 frameInterval = Max(terminal->SmoothedWriteTime * 2, (u64)TERMINAL_MIN_FRAME_INTERVAL);
+    terminal->Statistics.FrameInterval = Min(frameInterval, (u64)TERMINAL_MAX_FRAME_INTERVAL);
+}
+
+void* RunTerminalWriter(void* argument)
+{
+    Terminal* terminal = (Terminal*)argument;
+
+    pthread_mutex_lock(&terminal->Lock);
+    while (true)
+    {
+        while (terminal->Pending.Length == 0 && terminal->Running)
+            pthread_cond_wait(&terminal->FrameReady, &terminal->Lock);
+
+        if (terminal->Pending.Length == 0)
+            break;
+
+        String frame = terminal->Writing;
+        terminal->Writing = terminal->Pending;
+        terminal->Pending = frame;
+        terminal->Busy = true;
+        pthread_mutex_unlock(&terminal->Lock);
+
+        ProfileScope writeScope = BeginProfileScope("WriteStdOut");
+        u64 writeStart = GetMonotonicTime();
+        WriteTerminalOutput(terminal, terminal->Writing.Content, terminal->Writing.Length);
+        u64 writeTime = GetMonotonicTime() - writeStart;
+        EndProfileScope(writeScope);
+
+        int pendingBytes = 0;
+#if defined(TIOCOUTQ)
+        ioctl(terminal->Output, TIOCOUTQ, &pendingBytes);
+#endif
+
+        pthread_mutex_lock(&terminal->Lock);
+        terminal->Statistics.BytesWritten += terminal->Writing.Length;
+        AdaptFrameInterval(terminal, writeTime, (u64)Max(pendingBytes, 0));
+        terminal->Writing.Length = 0;
+        terminal->Busy = false;
+        pthread_cond_broadcast(&terminal->FrameWritten);
+
+        u64 frameInterval = terminal->Statistics.FrameInterval;
+        if (frameInterval > writeTime)
+        {
+            struct timespec deadline;
+            MakeTerminalDeadline(&deadline, frameInterval - writeTime);
+            while (terminal->Running && pthread_cond_timedwait(&terminal->FrameReady, &terminal->Lock, &deadline) != ETIMEDOUT)
+            {
+            }
+        }
+    }
+    pthread_mutex_unlock(&terminal->Lock);
+
+    return NULL;
 }
 
 KeyModifier GetKeyModifiers(u8 value)
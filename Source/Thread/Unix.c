@@ -0,0 +1,211 @@
+#include <Thread.h>
+
+#if defined(LIE_PLATFORM_LINUX) || defined(LIE_PLATFORM_MACOS)
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+struct ThreadPool
+{
+    pthread_t* Threads;
+    usize ThreadCount;
+
+    pthread_mutex_t Lock;
+    pthread_cond_t WorkReady;
+    pthread_cond_t WorkDone;
+
+    ThreadTask Task;
+    void* Context;
+    usize Count;
+    _Atomic usize NextIndex;
+
+    u64 Generation;
+    usize ActiveThreads;
+    bool Running;
+};
+
+struct ThreadLock
+{
+    pthread_mutex_t Mutex;
+};
+
+struct BackgroundThread
+{
+    pthread_t Thread;
+    BackgroundTask Task;
+    void* Context;
+    bool Started;
+};
+
+usize GetProcessorCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (usize)count : 1;
+}
+
+void RunThreadPoolTasks(ThreadPool* pool)
+{
+    while (true)
+    {
+        usize index = atomic_fetch_add(&pool->NextIndex, 1);
+        if (index >= pool->Count)
+            return;
+
+        pool->Task(pool->Context, index);
+    }
+}
+
+void* RunThreadPoolWorker(void* argument)
+{
+    ThreadPool* pool = (ThreadPool*)argument;
+    u64 generation = 0;
+
+    pthread_mutex_lock(&pool->Lock);
+    while (true)
+    {
+        while (pool->Running && pool->Generation == generation)
+            pthread_cond_wait(&pool->WorkReady, &pool->Lock);
+
+        if (!pool->Running)
+            break;
+
+        generation = pool->Generation;
+        pthread_mutex_unlock(&pool->Lock);
+
+        RunThreadPoolTasks(pool);
+
+        pthread_mutex_lock(&pool->Lock);
+        pool->ActiveThreads -= 1;
+        if (pool->ActiveThreads == 0)
+            pthread_cond_signal(&pool->WorkDone);
+    }
+
+    pthread_mutex_unlock(&pool->Lock);
+    return NULL;
+}
+
+ThreadPool* CreateThreadPool(usize threadCount)
+{
+    ThreadPool* pool = (ThreadPool*)MemoryAllocate(sizeof(ThreadPool));
+    MemoryClear(pool, sizeof(ThreadPool));
+
+    pthread_mutex_init(&pool->Lock, NULL);
+    pthread_cond_init(&pool->WorkReady, NULL);
+    pthread_cond_init(&pool->WorkDone, NULL);
+    pool->Running = true;
+
+    if (threadCount == 0)
+        threadCount = GetProcessorCount();
+
+    usize workerCount = threadCount - 1;
+    if (workerCount > 0)
+        pool->Threads = (pthread_t*)MemoryAllocate(workerCount * sizeof(pthread_t));
+
+    for (usize index = 0; index < workerCount; index += 1)
+    {
+        if (pthread_create(&pool->Threads[pool->ThreadCount], NULL, RunThreadPoolWorker, pool) == 0)
+            pool->ThreadCount += 1;
+    }
+
+    return pool;
+}
+
+void DestroyThreadPool(ThreadPool* pool)
+{
+    pthread_mutex_lock(&pool->Lock);
+    pool->Running = false;
+    pthread_cond_broadcast(&pool->WorkReady);
+    pthread_mutex_unlock(&pool->Lock);
+
+    for (usize index = 0; index < pool->ThreadCount; index += 1)
+        pthread_join(pool->Threads[index], NULL);
+
+    pthread_cond_destroy(&pool->WorkDone);
+    pthread_cond_destroy(&pool->WorkReady);
+    pthread_mutex_destroy(&pool->Lock);
+
+    MemoryFree(pool->Threads);
+    MemoryFree(pool);
+}
+
+usize GetThreadPoolSize(ThreadPool* pool)
+{
+    return pool->ThreadCount + 1;
+}
+
+void RunThreadPool(ThreadPool* pool, ThreadTask task, void* context, usize count)
+{
+    if (count == 0)
+        return;
+
+    pthread_mutex_lock(&pool->Lock);
+    pool->Task = task;
+    pool->Context = context;
+    pool->Count = count;
+    atomic_store(&pool->NextIndex, 0);
+    pool->ActiveThreads = pool->ThreadCount;
+    pool->Generation += 1;
+    pthread_cond_broadcast(&pool->WorkReady);
+    pthread_mutex_unlock(&pool->Lock);
+
+    RunThreadPoolTasks(pool);
+
+    pthread_mutex_lock(&pool->Lock);
+    while (pool->ActiveThreads > 0)
+        pthread_cond_wait(&pool->WorkDone, &pool->Lock);
+    pthread_mutex_unlock(&pool->Lock);
+}
+
+ThreadLock* CreateThreadLock()
+{
+    ThreadLock* lock = (ThreadLock*)MemoryAllocate(sizeof(ThreadLock));
+    pthread_mutex_init(&lock->Mutex, NULL);
+    return lock;
+}
+
+void DestroyThreadLock(ThreadLock* lock)
+{
+    pthread_mutex_destroy(&lock->Mutex);
+    MemoryFree(lock);
+}
+
+void AcquireThreadLock(ThreadLock* lock)
+{
+    pthread_mutex_lock(&lock->Mutex);
+}
+
+void ReleaseThreadLock(ThreadLock* lock)
+{
+    pthread_mutex_unlock(&lock->Mutex);
+}
+
+void* RunBackgroundThread(void* argument)
+{
+    BackgroundThread* thread = (BackgroundThread*)argument;
+    thread->Task(thread->Context);
+    return NULL;
+}
+
+BackgroundThread* StartBackgroundThread(BackgroundTask task, void* context)
+{
+    BackgroundThread* thread = (BackgroundThread*)MemoryAllocate(sizeof(BackgroundThread));
+    thread->Task = task;
+    thread->Context = context;
+    thread->Started = pthread_create(&thread->Thread, NULL, RunBackgroundThread, thread) == 0;
+
+    if (!thread->Started)
+        task(context);
+
+    return thread;
+}
+
+void JoinBackgroundThread(BackgroundThread* thread)
+{
+    if (thread->Started)
+        pthread_join(thread->Thread, NULL);
+
+    MemoryFree(thread);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include <Unicode.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+typedef struct UnicodeRange
+{
+    u32 First;
+    u32 Last;
+} UnicodeRange;
+
+static const UnicodeRange ZeroWidthRanges[] = {
+    {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x0610, 0x061A}, {0x064B, 0x065F}, {0x0670, 0x0670},
+    {0x06D6, 0x06DC}, {0x06DF, 0x06E4}, {0x0900, 0x0902}, {0x093A, 0x093A}, {0x093C, 0x093C}, {0x0941, 0x0948},
+    {0x094D, 0x094D}, {0x0E31, 0x0E31}, {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, {0x1AB0, 0x1AFF}, {0x1DC0, 0x1DFF},
+    {0x200B, 0x200F}, {0x202A, 0x202E}, {0x2060, 0x2064}, {0x20D0, 0x20FF}, {0xFE00, 0xFE0F}, {0xFE20, 0xFE2F},
+    {0xFEFF, 0xFEFF}, {0xE0100, 0xE01EF},
+};
+
+static const UnicodeRange WideRanges[] = {
+    {0x1100, 0x115F},   {0x231A, 0x231B},   {0x2329, 0x232A},   {0x23E9, 0x23EC},   {0x23F0, 0x23F0},
+    {0x23F3, 0x23F3},   {0x25FD, 0x25FE},   {0x2614, 0x2615},   {0x2648, 0x2653},   {0x267F, 0x267F},
+    {0x2693, 0x2693},   {0x26A1, 0x26A1},   {0x26AA, 0x26AB},   {0x26BD, 0x26BE},   {0x26C4, 0x26C5},
+    {0x26CE, 0x26CE},   {0x26D4, 0x26D4},   {0x26EA, 0x26EA},   {0x26F2, 0x26F3},   {0x26F5, 0x26F5},
+    {0x26FA, 0x26FA},   {0x26FD, 0x26FD},   {0x2705, 0x2705},   {0x270A, 0x270B},   {0x2728, 0x2728},
+    {0x274C, 0x274C},   {0x274E, 0x274E},   {0x2753, 0x2755},   {0x2757, 0x2757},   {0x2795, 0x2797},
+    {0x27B0, 0x27B0},   {0x27BF, 0x27BF},   {0x2B1B, 0x2B1C},   {0x2B50, 0x2B50},   {0x2B55, 0x2B55},
+    {0x2E80, 0x303E},   {0x3041, 0x33FF},   {0x3400, 0x4DBF},   {0x4E00, 0x9FFF},   {0xA000, 0xA4CF},
+    {0xA960, 0xA97F},   {0xAC00, 0xD7A3},   {0xF900, 0xFAFF},   {0xFE10, 0xFE19},   {0xFE30, 0xFE6F},
+    {0xFF00, 0xFF60},   {0xFFE0, 0xFFE6},   {0x16FE0, 0x16FE4}, {0x17000, 0x18CFF}, {0x1B000, 0x1B2FF},
+    {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F251},
+    {0x1F300, 0x1F320}, {0x1F32D, 0x1F335}, {0x1F337, 0x1F37C}, {0x1F37E, 0x1F393}, {0x1F3A0, 0x1F3CA},
+    {0x1F3CF, 0x1F3D3}, {0x1F3E0, 0x1F3F0}, {0x1F3F4, 0x1F3F4}, {0x1F3F8, 0x1F43E}, {0x1F440, 0x1F440},
+    {0x1F442, 0x1F4FC}, {0x1F4FF, 0x1F53D}, {0x1F54B, 0x1F54E}, {0x1F550, 0x1F567}, {0x1F57A, 0x1F57A},
+    {0x1F595, 0x1F596}, {0x1F5A4, 0x1F5A4}, {0x1F5FB, 0x1F64F}, {0x1F680, 0x1F6C5}, {0x1F6CC, 0x1F6CC},
+    {0x1F6D0, 0x1F6D2}, {0x1F6D5, 0x1F6D7}, {0x1F6DC, 0x1F6DF}, {0x1F6EB, 0x1F6EC}, {0x1F6F4, 0x1F6FC},
+    {0x1F7E0, 0x1F7EB}, {0x1F7F0, 0x1F7F0}, {0x1F90C, 0x1F93A}, {0x1F93C, 0x1F945}, {0x1F947, 0x1F9FF},
+    {0x1FA70, 0x1FAFF}, {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+};
+
+usize DecodeUtf8(const char* bytes, usize length, u32* codepoint)
+{
+    u8 lead = (u8)bytes[0];
+    if (lead < 0x80)
+    {
+        *codepoint = lead;
+        return 1;
+    }
+
+    usize size;
+    u32 value;
+    u32 minimum;
+    if ((lead & 0xE0) == 0xC0)
+    {
+        size = 2;
+        value = lead & 0x1F;
+        minimum = 0x80;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        size = 3;
+        value = lead & 0x0F;
+        minimum = 0x800;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        size = 4;
+        value = lead & 0x07;
+        minimum = 0x10000;
+    }
+    else
+    {
+        *codepoint = UNICODE_REPLACEMENT_CHARACTER;
+        return 1;
+    }
+
+    if (size > length)
+    {
+        *codepoint = UNICODE_REPLACEMENT_CHARACTER;
+        return 1;
+    }
+
+    for (usize index = 1; index < size; index += 1)
+    {
+        u8 continuation = (u8)bytes[index];
+        if ((continuation & 0xC0) != 0x80)
+        {
+            *codepoint = UNICODE_REPLACEMENT_CHARACTER;
+            return 1;
+        }
+
+        value = (value << 6) | (continuation & 0x3F);
+    }
+
+    if (value < minimum || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF))
+    {
+        *codepoint = UNICODE_REPLACEMENT_CHARACTER;
+        return 1;
+    }
+
+    *codepoint = value;
+    return size;
+}
+
+usize EncodeUtf8(u32 codepoint, char* bytes)
+{
+    if (codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        codepoint = UNICODE_REPLACEMENT_CHARACTER;
+
+    if (codepoint < 0x80)
+    {
+        bytes[0] = (char)codepoint;
+        return 1;
+    }
+
+    if (codepoint < 0x800)
+    {
+        bytes[0] = (char)(0xC0 | (codepoint >> 6));
+        bytes[1] = (char)(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+
+    if (codepoint < 0x10000)
+    {
+        bytes[0] = (char)(0xE0 | (codepoint >> 12));
+        bytes[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        bytes[2] = (char)(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+
+    bytes[0] = (char)(0xF0 | (codepoint >> 18));
+    bytes[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+    bytes[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+    bytes[3] = (char)(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+usize GetUtf8SequenceLength(char lead)
+{
+    u8 value = (u8)lead;
+    if ((value & 0xE0) == 0xC0)
+        return 2;
+
+    if ((value & 0xF0) == 0xE0)
+        return 3;
+
+    if ((value & 0xF8) == 0xF0)
+        return 4;
+
+    return 1;
+}
+
+usize SkipAsciiBytes(StringView text, usize byte)
+{
+#if defined(__SSE2__)
+    for (; byte + 16 <= text.Length; byte += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(text.Content + byte));
+        u32 mask = (u32)_mm_movemask_epi8(block);
+        if (mask != 0)
+            return byte + (usize)__builtin_ctz(mask);
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t highs = vdupq_n_u8(0x80);
+    for (; byte + 16 <= text.Length; byte += 16)
+    {
+        uint8x16_t block = vcgeq_u8(vld1q_u8((const u8*)(text.Content + byte)), highs);
+        u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(block), 4)), 0);
+        if (mask != 0)
+            return byte + (usize)__builtin_ctzll(mask) / 4;
+    }
+#endif
+
+    while (byte < text.Length && (u8)text.Content[byte] < 0x80)
+        byte += 1;
+
+    return byte;
+}
+
+usize ValidateUtf8(StringView text)
+{
+    usize byte = SkipAsciiBytes(text, 0);
+    while (byte < text.Length)
+    {
+        u32 codepoint;
+        usize size = DecodeUtf8(text.Content + byte, text.Length - byte, &codepoint);
+        if (size == 1 && (u8)text.Content[byte] >= 0x80)
+            return byte;
+
+        byte = SkipAsciiBytes(text, byte + size);
+    }
+
+    return text.Length;
+}
+
+usize FindPreviousCodepoint(StringView text, usize byte)
+{
+    if (byte == 0)
+        return 0;
+
+    usize start = byte - 1;
+    usize limit = byte - Min(byte, (usize)4);
+    while (start > limit && ((u8)text.Content[start] & 0xC0) == 0x80)
+        start -= 1;
+
+    u32 codepoint;
+    if (DecodeUtf8(text.Content + start, text.Length - start, &codepoint) == byte - start)
+        return start;
+
+    return byte - 1;
+}
+
+usize FindNextCodepoint(StringView text, usize byte)
+{
+    if (byte >= text.Length)
+        return text.Length;
+
+    u32 codepoint;
+    return byte + DecodeUtf8(text.Content + byte, text.Length - byte, &codepoint);
+}
+
+bool IsInUnicodeRanges(const UnicodeRange* ranges, usize count, u32 codepoint)
+{
+    usize low = 0, high = count;
+    while (low < high)
+    {
+        usize middle = low + (high - low) / 2;
+        if (ranges[middle].Last < codepoint)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low < count && ranges[low].First <= codepoint;
+}
+
+usize GetCodepointWidth(u32 codepoint)
+{
+    if (codepoint < 0x0300)
+        return 1;
+
+    if (IsInUnicodeRanges(ZeroWidthRanges, sizeof(ZeroWidthRanges) / sizeof(ZeroWidthRanges[0]), codepoint))
+        return 0;
+
+    if (IsInUnicodeRanges(WideRanges, sizeof(WideRanges) / sizeof(WideRanges[0]), codepoint))
+        return 2;
+
+    return 1;
+}
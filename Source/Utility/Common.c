@@ -73,6 +73,37 @@ void MemoryCopy(void* destination, const void* source, usize size)
     }
 }
 
+bool MemoryEquals(const void* left, const void* right, usize size)
+{
+    const u8* leftBytes = (const u8*)left;
+    const u8* rightBytes = (const u8*)right;
+
+    while (size >= 8)
+    {
+        u64 leftValue, rightValue;
+        MemoryCopy(&leftValue, leftBytes, 8);
+        MemoryCopy(&rightValue, rightBytes, 8);
+        if (leftValue != rightValue)
+            return false;
+
+        leftBytes += 8;
+        rightBytes += 8;
+        size -= 8;
+    }
+
+    while (size >= 1)
+    {
+        if (*leftBytes != *rightBytes)
+            return false;
+
+        leftBytes += 1;
+        rightBytes += 1;
+        size -= 1;
+    }
+
+    return true;
+}
+
 bool IsDigit(char c)
 {
     return '0' <= c && c <= '9';
@@ -178,19 +209,42 @@ void AppendStringView(String* string, StringView view)
 
 void AppendUInt(String* string, u64 value)
 {
-    static char buffer[32];
+    char buffer[32];
     usize index = 31;
-    while (value > 0)
+    do
     {
-        buffer[index] = '0' + (value % 10);
+        buffer[index] = (char)('0' + (value % 10));
         value /= 10;
         index -= 1;
-    }
+    } while (value > 0);
 
     StringView view = {.Length = 32 - index - 1, .Content = buffer + index + 1};
     AppendStringView(string, view);
 }
 
+void AppendByteSize(String* string, u64 bytes)
+{
+    static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+
+    usize unit = 0;
+    u64 scaled = bytes * 10;
+    while (scaled >= 10240 && unit < 4)
+    {
+        scaled /= 1024;
+        unit += 1;
+    }
+
+    AppendUInt(string, scaled / 10);
+    if (unit > 0)
+    {
+        AppendChar(string, '.');
+        AppendUInt(string, scaled % 10);
+    }
+
+    AppendChar(string, ' ');
+    AppendStr(string, units[unit]);
+}
+
 void InsertChar(String* string, usize index, char c)
 {
     if (index > string->Length)
@@ -208,6 +262,20 @@ void InsertChar(String* string, usize index, char c)
     string->Content[string->Length] = '\0';
 }
 
+void InsertStringView(String* string, usize index, StringView view)
+{
+    if (index > string->Length)
+        index = string->Length;
+
+    ExtendString(string, string->Length + view.Length);
+
+    MemoryCopy(string->Content + index + view.Length, string->Content + index, string->Length - index);
+    MemoryCopy(string->Content + index, view.Content, view.Length);
+    string->Length += view.Length;
+
+    string->Content[string->Length] = '\0';
+}
+
 StringView ToStringView(String* string)
 {
     return (StringView){.Length = string->Length, .Content = string->Content};
@@ -218,6 +286,33 @@ StringView MakeStringView(String* string, usize start, usize end)
     return (StringView){.Length = end - start, .Content = string->Content + start};
 }
 
+StringView MakeStringViewFromStr(const char* str)
+{
+    return (StringView){.Length = GetStrLength(str), .Content = str};
+}
+
+bool StringViewEquals(StringView left, StringView right)
+{
+    if (left.Length != right.Length)
+        return false;
+
+    for (usize index = 0; index < left.Length; index++)
+    {
+        if (left.Content[index] != right.Content[index])
+            return false;
+    }
+
+    return true;
+}
+
+bool StringViewStartsWith(StringView view, StringView prefix)
+{
+    if (view.Length < prefix.Length)
+        return false;
+
+    return StringViewEquals((StringView){.Length = prefix.Length, .Content = view.Content}, prefix);
+}
+
 bool TryParseUInt(StringView view, u64* value)
 {
     *value = 0;
@@ -0,0 +1,246 @@
+#include <Utility.h>
+
+#define MEMORY_HEADER_SIZE      16
+#define MEMORY_BLOCK_CLASS_MIN  5
+#define MEMORY_BLOCK_CLASS_MAX  12
+#define MEMORY_BLOCK_CLASS_NONE 0
+#define MEMORY_ARENA_SIZE       (1 << 20)
+
+typedef struct MemoryHeader
+{
+    usize Size;
+    u32 BlockClass;
+    u32 Site;
+} MemoryHeader;
+
+typedef struct MemoryBlock
+{
+    struct MemoryBlock* Next;
+} MemoryBlock;
+
+typedef struct MemoryState
+{
+    u8* ArenaCursor;
+    u8* ArenaEnd;
+    MemoryBlock* FreeBlocks[MEMORY_BLOCK_CLASS_MAX + 1];
+
+    MemoryStatistics Statistics;
+    MemoryCallSite Sites[MEMORY_CALL_SITE_COUNT];
+} MemoryState;
+
+static MemoryState GlobalMemory;
+
+u32 GetCeilLog2(usize value)
+{
+    u32 log = 0;
+    while (((usize)1 << log) < value)
+        log += 1;
+
+    return log;
+}
+
+u32 RecordMemoryCallSite(const char* file, u32 line, usize size)
+{
+    if (file == NULL)
+        return 0;
+
+    usize hash = ((usize)file >> 4) * 31 + line;
+    for (usize probe = 0; probe < MEMORY_CALL_SITE_COUNT - 1; probe += 1)
+    {
+        usize index = 1 + (hash + probe) % (MEMORY_CALL_SITE_COUNT - 1);
+        MemoryCallSite* site = &GlobalMemory.Sites[index];
+        if (site->File == NULL)
+        {
+            site->File = file;
+            site->Line = line;
+        }
+
+        if (site->File == file && site->Line == line)
+        {
+            site->Allocations += 1;
+            site->LiveBytes += size;
+            return (u32)index;
+        }
+    }
+
+    return 0;
+}
+
+void* AllocateBlock(u32 blockClass)
+{
+    MemoryBlock* block = GlobalMemory.FreeBlocks[blockClass];
+    if (block != NULL)
+    {
+        GlobalMemory.FreeBlocks[blockClass] = block->Next;
+        return block;
+    }
+
+    usize blockSize = (usize)1 << blockClass;
+    if (GlobalMemory.ArenaCursor == NULL || (usize)(GlobalMemory.ArenaEnd - GlobalMemory.ArenaCursor) < blockSize)
+    {
+        u8* arena = (u8*)AllocatePages(MEMORY_ARENA_SIZE);
+        if (arena == NULL)
+            return NULL;
+
+        GlobalMemory.ArenaCursor = arena;
+        GlobalMemory.ArenaEnd = arena + MEMORY_ARENA_SIZE;
+    }
+
+    void* result = GlobalMemory.ArenaCursor;
+    GlobalMemory.ArenaCursor += blockSize;
+    return result;
+}
+
+void* MemoryAllocateAt(usize size, const char* file, u32 line)
+{
+    usize totalSize = size + MEMORY_HEADER_SIZE;
+    u32 blockClass = Max(GetCeilLog2(totalSize), MEMORY_BLOCK_CLASS_MIN);
+
+    MemoryHeader* header;
+    if (blockClass <= MEMORY_BLOCK_CLASS_MAX)
+    {
+        LockMemory();
+        header = (MemoryHeader*)AllocateBlock(blockClass);
+        if (header == NULL)
+        {
+            UnlockMemory();
+            return NULL;
+        }
+    }
+    else
+    {
+        header = (MemoryHeader*)AllocatePages(totalSize);
+        blockClass = MEMORY_BLOCK_CLASS_NONE;
+        if (header == NULL)
+            return NULL;
+
+        LockMemory();
+    }
+
+    MemoryStatistics* statistics = &GlobalMemory.Statistics;
+    statistics->LiveBytes += size;
+    statistics->PeakBytes = Max(statistics->PeakBytes, statistics->LiveBytes);
+    statistics->Allocations += 1;
+    statistics->SizeClasses[Min(GetCeilLog2(Max(size, 16)) - 4, MEMORY_SIZE_CLASS_COUNT - 1)] += 1;
+
+    header->Size = size;
+    header->BlockClass = blockClass;
+    header->Site = RecordMemoryCallSite(file, line, size);
+
+    UnlockMemory();
+    return (u8*)header + MEMORY_HEADER_SIZE;
+}
+
+void MemoryFree(void* source)
+{
+    if (source == NULL)
+        return;
+
+    MemoryHeader* header = (MemoryHeader*)((u8*)source - MEMORY_HEADER_SIZE);
+    usize size = header->Size;
+    u32 blockClass = header->BlockClass;
+
+    LockMemory();
+
+    GlobalMemory.Statistics.LiveBytes -= size;
+    GlobalMemory.Statistics.Frees += 1;
+    if (header->Site != 0)
+        GlobalMemory.Sites[header->Site].LiveBytes -= size;
+
+    if (blockClass != MEMORY_BLOCK_CLASS_NONE)
+    {
+        MemoryBlock* block = (MemoryBlock*)header;
+        block->Next = GlobalMemory.FreeBlocks[blockClass];
+        GlobalMemory.FreeBlocks[blockClass] = block;
+    }
+
+    UnlockMemory();
+
+    if (blockClass == MEMORY_BLOCK_CLASS_NONE)
+        FreePages(header, size + MEMORY_HEADER_SIZE);
+}
+
+void GetMemoryStatistics(MemoryStatistics* statistics)
+{
+    LockMemory();
+    *statistics = GlobalMemory.Statistics;
+    UnlockMemory();
+}
+
+usize GetMemoryCallSites(MemoryCallSite* sites, usize capacity)
+{
+    usize count = 0;
+
+    LockMemory();
+    for (usize index = 1; index < MEMORY_CALL_SITE_COUNT && count < capacity; index += 1)
+    {
+        if (GlobalMemory.Sites[index].File != NULL)
+        {
+            sites[count] = GlobalMemory.Sites[index];
+            count += 1;
+        }
+    }
+    UnlockMemory();
+
+    return count;
+}
+
+void AppendMemoryStatistics(String* string)
+{
+    MemoryStatistics statistics;
+    GetMemoryStatistics(&statistics);
+
+    AppendStr(string, "Memory: ");
+    AppendByteSize(string, statistics.LiveBytes);
+    AppendStr(string, " live, ");
+    AppendByteSize(string, statistics.PeakBytes);
+    AppendStr(string, " peak, ");
+    AppendUInt(string, statistics.Allocations);
+    AppendStr(string, " allocations");
+}
+
+void AppendMemoryReport(String* string)
+{
+    MemoryStatistics statistics;
+    GetMemoryStatistics(&statistics);
+
+    AppendStr(string, "Memory statistics\n  Live bytes:  ");
+    AppendUInt(string, statistics.LiveBytes);
+    AppendStr(string, "\n  Peak bytes:  ");
+    AppendUInt(string, statistics.PeakBytes);
+    AppendStr(string, "\n  Allocations: ");
+    AppendUInt(string, statistics.Allocations);
+    AppendStr(string, "\n  Frees:       ");
+    AppendUInt(string, statistics.Frees);
+    AppendStr(string, "\nSize classes\n");
+
+    for (usize index = 0; index < MEMORY_SIZE_CLASS_COUNT; index += 1)
+    {
+        if (statistics.SizeClasses[index] == 0)
+            continue;
+
+        AppendStr(string, (index + 1 < MEMORY_SIZE_CLASS_COUNT) ? "  <= " : "  >  ");
+        AppendByteSize(string, (u64)1 << (index + 4 - (index + 1 == MEMORY_SIZE_CLASS_COUNT)));
+        AppendStr(string, ": ");
+        AppendUInt(string, statistics.SizeClasses[index]);
+        AppendChar(string, '\n');
+    }
+
+    MemoryCallSite sites[MEMORY_CALL_SITE_COUNT];
+    usize siteCount = GetMemoryCallSites(sites, MEMORY_CALL_SITE_COUNT);
+    if (siteCount > 0)
+        AppendStr(string, "Call sites\n");
+
+    for (usize index = 0; index < siteCount; index += 1)
+    {
+        AppendStr(string, "  ");
+        AppendStr(string, sites[index].File);
+        AppendChar(string, ':');
+        AppendUInt(string, sites[index].Line);
+        AppendStr(string, ": ");
+        AppendUInt(string, sites[index].Allocations);
+        AppendStr(string, " allocations, ");
+        AppendUInt(string, sites[index].LiveBytes);
+        AppendStr(string, " bytes live\n");
+    }
+}
\ No newline at end of file
@@ -2,16 +2,44 @@
 
 #if defined(LIE_PLATFORM_LINUX) || defined(LIE_PLATFORM_MACOS)
 
+#include <pthread.h>
 #include <sys/mman.h>
+#include <time.h>
 
-void* MemoryAllocate(usize size)
+static pthread_mutex_t MemoryLock = PTHREAD_MUTEX_INITIALIZER;
+
+void* AllocatePages(usize size)
+{
+    void* pages = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (pages == MAP_FAILED) ? NULL : pages;
+}
+
+void FreePages(void* pages, usize size)
+{
+    munmap(pages, size);
+}
+
+void LockMemory()
+{
+    pthread_mutex_lock(&MemoryLock);
+}
+
+void UnlockMemory()
+{
+    pthread_mutex_unlock(&MemoryLock);
+}
+
+u64 GetMonotonicTime()
 {
-    return mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (u64)time.tv_sec * 1000000000 + (u64)time.tv_nsec;
 }
 
-void MemoryFree(void* source)
+void SleepFor(u64 nanoseconds)
 {
-    munmap(source, 0);
+    struct timespec time = {.tv_sec = (time_t)(nanoseconds / 1000000000), .tv_nsec = (long)(nanoseconds % 1000000000)};
+    nanosleep(&time, NULL);
 }
 
 #endif
\ No newline at end of file